@@ -1,4 +1,5 @@
 #include "generators.h"
+#include <cxl/lexer.hpp>
 #include <cxl/parsers.hpp>
 #include <cxl/string.hpp>
 
@@ -32,4 +33,10 @@ constexpr auto quote = one_char(STR("'"));
 constexpr auto string = (quote & (*(!one_char(STR("'")))).generate(generators::quoted_string<>{}) & quote);
 constexpr auto value = floating | integer | string;
 constexpr auto value_list = token_list(value, one_char(STR(",")));
+
+// the same list over tokens, the lexer drops whitespace once, so the grammar only sees values and commas
+constexpr auto comma = one_char(STR(","));
+constexpr auto lex = lexer(+skip, floating, integer, string, comma);
+constexpr auto value_token = lex.token(floating) | lex.token(integer) | lex.token(string);
+constexpr auto value_token_list = value_token & *(lex.token(comma) & value_token);
 } // namespace grammar
\ No newline at end of file
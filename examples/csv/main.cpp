@@ -1,14 +1,139 @@
 #include "grammar.h"
 #include <cxl/integral.hpp>
+#include <cxl/mapped_file.hpp>
+#include <cxl/parallel.hpp>
+#include <cxl/regex.hpp>
+#include <cxl/stream.hpp>
 
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// the keyword N<units><tens> of { Index }, the rules keep a one_of of them from being merged into a single automaton
+template <cxl::index_t Index>
+struct keyword
+{
+  static constexpr auto definition()
+  {
+    return cxl::parse::one_string<cxl::string<'N', char('0' + Index % 10), char('0' + Index / 10)>>{};
+  }
+};
+
+template <cxl::index_t... Indices>
+constexpr auto
+keywords(std::integer_sequence<cxl::index_t, Indices...>)
+{
+  return cxl::parse::one_of<cxl::parse::rule<keyword<Indices>>...>{};
+}
 
 int
-main()
+main(int argc, char *argv[])
 {
   using namespace cxl::literals;
   constexpr auto match_result = grammar::value_list.parse(STR("1, 2, 3, 42,0, 11 , 91 ,'hi'")).tree();
   constexpr auto fifth_element = match_result[4_i];
   std::cout << match_result[7_i]() << "\n";
+
+  // a string literal, a std::string or any other runtime string is parsed at runtime
+  static_assert(grammar::value_list.parse("1, 2, 3").length() == 7);
+  const std::string text{"1, 2, 'hi'"};
+  std::cout << grammar::value_list.parse(text).length() << "\n";
+
+  // capture<...>(...) runs the grammar as plain constexpr code, so it scales to long inputs
+  constexpr auto captured = cxl::parse::capture<8>(grammar::value_list, "1, 2, 3, 42,0, 11 , 91 ,'hi'");
+  static_assert(captured.status() && captured.size() == 8 && captured[7].match() == "hi");
+
+  // runtime_generate<...>(...) hands every generator's output template and matched text to a visitor
+  constexpr auto integers = [] {
+    cxl::index_t count = 0;
+    cxl::parse::runtime_generate<8>(grammar::value_list, "1, 2.5, 'hi', 3", [&](auto output, std::string_view) {
+      count += std::is_same_v<decltype(output), generators::integer<>>;
+    });
+    return count;
+  }();
+  static_assert(integers == 2);
+  static_assert(cxl::parse::runtime_generate<2>(grammar::value_list, "1, 2, 3", [](auto, std::string_view) {})
+                    .overflowed());
+
+  // tokenize<...>(...) splits the input once, parse_tokens(...) then runs a grammar over the token kinds
+  constexpr auto tokens = cxl::parse::tokenize<16>(grammar::lex, "1, 2, 3, 42,0, 11 , 91 ,'hi'");
+  static_assert(tokens.status() && tokens.size() == 15 && tokens[14].length == 4);
+  static_assert(cxl::parse::parse_tokens(grammar::value_token_list, tokens).length() == 28);
+
+  // stream<...>(...) reads the same list from chunks, records are handed out as soon as they are complete
+  constexpr auto streamed = [] {
+    auto values = cxl::parse::stream<16>(grammar::token(grammar::value), grammar::token(grammar::comma));
+    cxl::index_t count = 0;
+    const auto on_record = [&](std::string_view) { ++count; };
+    values.feed("1, 2, 3, 4", on_record);
+    values.feed("2,0, 11 , 91 ,'", on_record);
+    values.feed("hi'", on_record);
+    return values.finish(on_record) ? count : -1;
+  }();
+  static_assert(streamed == 8);
+
+  // stream<...>(record) reads records back to back, here single digits
+  constexpr auto digits = [] {
+    auto values = cxl::parse::stream<4>(grammar::digit);
+    cxl::index_t count = 0;
+    const auto on_record = [&](std::string_view) { ++count; };
+    values.feed("12", on_record);
+    values.feed("345", on_record);
+    return values.finish(on_record) ? count : -1;
+  }();
+  static_assert(digits == 5);
+
+  // a buffer holding exactly the largest separator and record is enough, more input than that overflows it
+  constexpr auto fits = [](std::string_view input) {
+    auto values = cxl::parse::stream<3>(+grammar::digit, grammar::comma);
+    const auto on_record = [](std::string_view) {};
+    return values.feed(input, on_record) && values.finish(on_record);
+  };
+  static_assert(fits("12,34") && !fits("12,345"));
+
+  // regex(...) compiles a pattern into a matcher, usable in static_asserts and on runtime input alike
+  constexpr auto number = cxl::regex(STR("[+-]?[0-9]+(\\.[0-9]*)?"));
+  static_assert(number.match("-42.5") && number.search("'hi', 91").offset() == 6);
+
+  // a commit only covers the sequence it is written in, also once simplify(...) flattened the grammar
+  constexpr auto a = cxl::parse::one_char(STR("a"));
+  constexpr auto b = cxl::parse::one_char(STR("b"));
+  constexpr auto committed = (a & cxl::parse::commit{} & b)[1_i] & cxl::parse::one_char(STR("c"));
+  constexpr auto either = committed | (a & b & cxl::parse::one_char(STR("d")));
+  static_assert(either.parse(STR("abd")).status() && cxl::parse::runtime_parse(either, "abd").length() == 3);
+
+  // a one_of of more alternatives than its lookahead table holds tries the ones past it in order
+  constexpr auto many = keywords(std::make_integer_sequence<cxl::index_t, 66>{});
+  static_assert(cxl::parse::runtime_parse(many, "N56").length() == 3 &&
+                cxl::parse::runtime_parse(many, "N46").length() == 3);
+  static_assert(!cxl::parse::runtime_parse(many, "N76").status());
+
+  // the same grammar validates runtime input, parallel_parse(...) splits it into chunks parsed on several threads
+  // and agrees with the sequential parse
+  // an argument @path names a file, mapped into memory instead of read
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string_view input{argv[i]};
+#if defined(CXL_HAS_MAPPED_FILE)
+    cxl::parse::mapped_file file;
+    if (input.size() > 1 && input[0] == '@')
+    {
+      file = cxl::parse::mapped_file(argv[i] + 1);
+      if (!file.status())
+        return 1;
+      input = file.view();
+    }
+#endif
+    const auto result = grammar::value_list.parse(input);
+    cxl::index_t records = 0;
+    const auto parallel = cxl::parse::parallel_parse(
+        grammar::token(grammar::value), grammar::token(grammar::comma), input, 4, [&](std::string_view) { ++records; }, 4);
+    if (parallel.status() != result.status() || parallel.length() != result.length())
+      return 1;
+    std::cout << argv[i] << ": " << (result.status() ? "matched " : "failed ") << result.length() << " chars, "
+              << records << " values\n";
+  }
   return fifth_element(); // 0 :)
 }
\ No newline at end of file
@@ -0,0 +1,290 @@
+#pragma once
+
+#include "scan.hpp"
+#include "utility.hpp"
+
+#include <cstdint>
+
+namespace cxl::parse
+{
+
+inline namespace detail
+{
+// a set of nfa states, one bit per state
+struct state_set
+{
+  ::std::uint64_t bits[2] = {};
+
+  constexpr bool contains(index_t state) const { return (bits[state >> 6] >> (state & 63)) & 1; }
+  constexpr void insert(index_t state) { bits[state >> 6] |= ::std::uint64_t(1) << (state & 63); }
+  constexpr bool operator==(const state_set &other) const
+  {
+    return bits[0] == other.bits[0] && bits[1] == other.bits[1];
+  }
+};
+
+// a thompson automaton, every state has at most one character transition and two empty ones, state 0 stands for
+// none so that a zero initialized transition leads nowhere, an automaton outgrowing its capacity is { overflowed }
+struct nfa
+{
+  static constexpr index_t capacity = 128;
+
+  char_table chars[capacity] = {};
+  index_t chars_target[capacity] = {};
+  index_t empty_target[capacity][2] = {};
+  index_t size = 1;
+  bool overflowed = false;
+
+  constexpr index_t add_state()
+  {
+    if (size == capacity)
+    {
+      overflowed = true;
+      return capacity - 1;
+    }
+    return size++;
+  }
+
+  // a transition from { from } on any character of { set } to a new state, which is returned
+  constexpr index_t add_chars(index_t from, const char_table &set)
+  {
+    const index_t to = add_state();
+    chars[from] = set;
+    chars_target[from] = to;
+    return to;
+  }
+
+  constexpr void add_empty(index_t from, index_t to)
+  {
+    if (empty_target[from][0] == 0)
+      empty_target[from][0] = to;
+    else if (empty_target[from][1] == 0)
+      empty_target[from][1] = to;
+    else
+      overflowed = true;
+  }
+
+  // { states } and every state reachable from them through empty transitions
+  constexpr state_set closure(state_set states) const
+  {
+    index_t pending[capacity] = {};
+    index_t count = 0;
+    for (index_t state = 1; state < size; ++state)
+      if (states.contains(state))
+        pending[count++] = state;
+    while (count > 0)
+    {
+      const index_t state = pending[--count];
+      for (const index_t target : empty_target[state])
+        if (target != 0 && !states.contains(target))
+        {
+          states.insert(target);
+          pending[count++] = target;
+        }
+    }
+    return states;
+  }
+};
+
+// a deterministic automaton under construction, characters no transition tells apart share a class so a state
+// has a row of { classes } transitions instead of 256, state 0 is the dead state every failed match ends in
+struct dfa_build
+{
+  static constexpr index_t max_states = 64;
+  static constexpr index_t max_classes = 64;
+
+  ::std::uint8_t class_of[256] = {};
+  unsigned char representative[max_classes] = {};
+  ::std::uint8_t next[max_states][max_classes] = {};
+  bool accepting[max_states] = {};
+  index_t states = 0;
+  index_t classes = 0;
+  index_t start = 0;
+  bool overflowed = false;
+};
+
+// splits the characters into classes, one split per distinct character transition
+constexpr void
+classify(const nfa &automaton, dfa_build &result)
+{
+  index_t classes = 1;
+  for (index_t state = 1; state < automaton.size; ++state)
+  {
+    if (automaton.chars_target[state] == 0)
+      continue;
+    index_t split[256][2] = {};
+    index_t split_classes = 0;
+    for (int c = 0; c < 256; ++c)
+    {
+      index_t &id = split[result.class_of[c]][automaton.chars[state].contains(static_cast<char>(c))];
+      if (id == 0)
+        id = ++split_classes;
+      if (id > dfa_build::max_classes)
+      {
+        result.overflowed = true;
+        return;
+      }
+      result.class_of[c] = static_cast<::std::uint8_t>(id - 1);
+    }
+    classes = split_classes;
+  }
+  result.classes = classes;
+  for (int c = 255; c >= 0; --c)
+    result.representative[result.class_of[c]] = static_cast<unsigned char>(c);
+}
+
+// the subset construction, every dfa state is the set of nfa states the characters so far may have led to
+constexpr dfa_build
+determinize(const nfa &automaton, index_t start, index_t final)
+{
+  dfa_build result;
+  classify(automaton, result);
+  if (result.overflowed || automaton.overflowed)
+  {
+    result.overflowed = true;
+    return result;
+  }
+  state_set sets[dfa_build::max_states] = {};
+  state_set initial;
+  initial.insert(start);
+  sets[1] = automaton.closure(initial);
+  result.states = 2;
+  result.start = 1;
+  for (index_t current = 1; current < result.states; ++current)
+  {
+    result.accepting[current] = sets[current].contains(final);
+    for (index_t k = 0; k < result.classes; ++k)
+    {
+      const char c = static_cast<char>(result.representative[k]);
+      state_set moved;
+      for (index_t state = 1; state < automaton.size; ++state)
+        if (sets[current].contains(state) && automaton.chars_target[state] != 0 && automaton.chars[state].contains(c))
+          moved.insert(automaton.chars_target[state]);
+      moved = automaton.closure(moved);
+      index_t target = 0;
+      while (target < result.states && !(sets[target] == moved))
+        ++target;
+      if (target == result.states)
+      {
+        if (result.states == dfa_build::max_states)
+        {
+          result.overflowed = true;
+          return result;
+        }
+        sets[result.states++] = moved;
+      }
+      result.next[current][k] = static_cast<::std::uint8_t>(target);
+    }
+  }
+  return result;
+}
+
+// moore's partition refinement, states are merged until only states some input tells apart remain, the dead
+// state is the first one visited so it keeps index 0
+constexpr dfa_build
+minimize(const dfa_build &automaton)
+{
+  if (automaton.overflowed)
+    return automaton;
+  index_t group[dfa_build::max_states] = {};
+  index_t groups = 0;
+  for (index_t state = 0; state < automaton.states; ++state)
+  {
+    index_t other = 0;
+    while (other < state && automaton.accepting[other] != automaton.accepting[state])
+      ++other;
+    group[state] = other < state ? group[other] : groups++;
+  }
+  for (index_t previous_groups = 0; previous_groups != groups;)
+  {
+    previous_groups = groups;
+    index_t refined[dfa_build::max_states] = {};
+    groups = 0;
+    for (index_t state = 0; state < automaton.states; ++state)
+    {
+      index_t other = 0;
+      for (; other < state; ++other)
+      {
+        bool same = group[other] == group[state];
+        for (index_t k = 0; same && k < automaton.classes; ++k)
+          same = group[automaton.next[other][k]] == group[automaton.next[state][k]];
+        if (same)
+          break;
+      }
+      refined[state] = other < state ? refined[other] : groups++;
+    }
+    for (index_t state = 0; state < automaton.states; ++state)
+      group[state] = refined[state];
+  }
+  dfa_build result;
+  for (int c = 0; c < 256; ++c)
+    result.class_of[c] = automaton.class_of[c];
+  result.classes = automaton.classes;
+  result.states = groups;
+  result.start = group[automaton.start];
+  for (index_t state = 0; state < automaton.states; ++state)
+  {
+    result.accepting[group[state]] = automaton.accepting[state];
+    for (index_t k = 0; k < automaton.classes; ++k)
+      result.next[group[state]][k] = static_cast<::std::uint8_t>(group[automaton.next[state][k]]);
+  }
+  return result;
+}
+
+// a minimized automaton laid out for matching, a row of 256 transitions per state so every character takes a
+// single lookup
+template <index_t States>
+struct dfa_table
+{
+  ::std::uint8_t next[States][256] = {};
+  bool accepting[States] = {};
+  index_t start = 0;
+
+  // the end of the longest match starting at { position }, or -1 when there is none, a run of characters a state
+  // loops on (digits, letters of an identifier, ...) is consumed by a loop whose lookups do not depend on each other,
+  // { examined } is set past the last character looked at, size + 1 when the end of the input was reached
+  constexpr index_t match(const char *data, index_t position, index_t size, index_t &examined) const
+  {
+    index_t state = start;
+    index_t end = -1;
+    while (state != 0)
+    {
+      const ::std::uint8_t *row = next[state];
+      while (position < size && row[static_cast<unsigned char>(data[position])] == state)
+        ++position;
+      if (accepting[state])
+        end = position;
+      if (position == size)
+      {
+        examined = size + 1;
+        return end;
+      }
+      state = row[static_cast<unsigned char>(data[position++])];
+    }
+    examined = position;
+    return end;
+  }
+
+  constexpr index_t match(const char *data, index_t position, index_t size) const
+  {
+    index_t examined = 0;
+    return match(data, position, size, examined);
+  }
+};
+
+template <index_t States>
+constexpr dfa_table<States>
+compact(const dfa_build &automaton)
+{
+  dfa_table<States> result;
+  for (index_t state = 0; state < States; ++state)
+  {
+    result.accepting[state] = automaton.accepting[state];
+    for (int c = 0; c < 256; ++c)
+      result.next[state][c] = automaton.next[state][automaton.class_of[c]];
+  }
+  result.start = automaton.start;
+  return result;
+}
+} // namespace detail
+} // namespace cxl::parse
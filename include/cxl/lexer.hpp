@@ -0,0 +1,177 @@
+#pragma once
+
+#include "parsed.hpp"
+#include "parsers.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace cxl::parse
+{
+
+// a token of a token_stream<...>, { kind } is the index of the lexer's token parser that matched it
+struct token_span
+{
+  index_t kind;
+  index_t offset;
+  index_t length;
+};
+
+// the tokens a lexer<...> found in { input }, the kind of every token is also kept as one character of { kinds() },
+// so grammars over tokens are ordinary parsers over that string, matching kinds with lexer<...>::token(...)
+template <index_t Capacity>
+struct token_stream
+{
+  constexpr token_stream(::std::string_view input) : m_input(input) {}
+
+  // the stream starts over, empty, for { input }
+  constexpr void reset(::std::string_view input)
+  {
+    m_input = input;
+    m_count = 0;
+    m_end = 0;
+    m_overflowed = false;
+  }
+
+  constexpr index_t size() const { return m_count; }
+  constexpr bool overflowed() const { return m_overflowed; }
+  // whether the whole input was split into tokens
+  constexpr bool status() const { return m_end == static_cast<index_t>(m_input.size()) && !m_overflowed; }
+  // where lexing stopped, the end of the input on success
+  constexpr index_t end() const { return m_end; }
+  constexpr ::std::string_view input() const { return m_input; }
+  constexpr ::std::string_view kinds() const { return {m_kinds.data(), static_cast<::std::size_t>(m_count)}; }
+
+  constexpr token_span operator[](index_t i) const
+  {
+    return {static_cast<unsigned char>(m_kinds[i]), m_offsets[i], m_lengths[i]};
+  }
+
+  constexpr bool push(index_t kind, index_t offset, index_t length)
+  {
+    if (m_count == Capacity)
+    {
+      m_overflowed = true;
+      return false;
+    }
+    m_kinds[m_count] = static_cast<char>(kind);
+    m_offsets[m_count] = offset;
+    m_lengths[m_count] = length;
+    ++m_count;
+    m_end = offset + length;
+    return true;
+  }
+
+  constexpr void skip_to(index_t end) { m_end = end; }
+
+private:
+  ::std::string_view m_input;
+  ::std::array<char, Capacity> m_kinds{};
+  ::std::array<index_t, Capacity> m_offsets{};
+  ::std::array<index_t, Capacity> m_lengths{};
+  index_t m_count = 0;
+  index_t m_end = 0;
+  bool m_overflowed = false;
+};
+
+// splits an input into tokens in one pass, at every position the input { SkipParser } matches is dropped, otherwise
+// the longest match of { TokenParsers } is the next token, the first of them wins a tie, and only the token parsers
+// that may start with the next character are tried
+template <typename SkipParser, typename... TokenParsers>
+struct lexer
+{
+  static_assert(sizeof...(TokenParsers) > 0 && sizeof...(TokenParsers) < 64,
+                "lexer<...> needs between 1 and 63 token parsers");
+
+  constexpr lexer() {}
+  constexpr lexer(SkipParser, TokenParsers...) {}
+
+  // the parser matching one token of { TokenParser }'s kind in the kinds() of a token_stream<...>
+  template <typename TokenParser>
+  static constexpr auto token(TokenParser)
+  {
+    constexpr index_t kind = index_of<TokenParser, TokenParsers...>(::std::integral_constant<index_t, 0>{});
+    return one_char<string<static_cast<char>(kind)>>{};
+  }
+
+  // the end of the longest token starting at { position } among the { viable } ones, its kind is set in { kind }
+  template <typename State, index_t... Kinds>
+  static constexpr index_t next_token(
+      State &state, index_t position, ::std::uint64_t viable, index_t &kind, ::std::integer_sequence<index_t, Kinds...>)
+  {
+    index_t best = no_match;
+    ((((viable >> Kinds) & 1) && [&] {
+       const index_t end = TokenParsers{}.parse_at(state, position);
+       if (end > best)
+       {
+         best = end;
+         kind = Kinds;
+       }
+       return true;
+     }()),
+     ...);
+    return best;
+  }
+};
+
+// lexes the input of { result } into it, when the stream is too large for the stack it can be allocated once and
+// filled by this overload
+template <index_t Capacity, typename SkipParser, typename... TokenParsers>
+constexpr void
+tokenize(lexer<SkipParser, TokenParsers...>, token_stream<Capacity> &result)
+{
+  runtime_state state{result.input()};
+  constexpr const prediction_table &table = prediction_table_of<TokenParsers...>;
+  constexpr auto skip = decltype(simplify(SkipParser{})){};
+  index_t position = 0;
+  while (position < state.size())
+  {
+    const index_t skipped = skip.parse_at(state, position);
+    if (skipped != no_match && skipped > position)
+    {
+      position = skipped;
+      result.skip_to(position);
+      continue;
+    }
+    index_t kind = 0;
+    const index_t end =
+        lexer<SkipParser, TokenParsers...>::next_token(state,
+                                                      position,
+                                                      table.viable[static_cast<unsigned char>(state.data[position])],
+                                                      kind,
+                                                      ::std::make_integer_sequence<index_t, sizeof...(TokenParsers)>{});
+    if (end == no_match || end == position || !result.push(kind, position, end - position))
+      break;
+    position = end;
+  }
+}
+
+// lexes { input } into at most { Capacity } tokens, being plain constexpr code it also runs during compilation
+template <index_t Capacity, typename SkipParser, typename... TokenParsers>
+constexpr auto
+tokenize(lexer<SkipParser, TokenParsers...> lex, ::std::string_view input)
+{
+  token_stream<Capacity> result{input};
+  tokenize(lex, result);
+  return result;
+}
+
+// runs { Parser }, a grammar over token kinds, over the tokens of { tokens }, the result locates the characters of
+// the tokens it matched in the lexed input
+template <typename Parser, index_t Capacity>
+constexpr auto
+parse_tokens(Parser, const token_stream<Capacity> &tokens)
+{
+  const parsed_view result = runtime_parse(Parser{}, tokens.kinds());
+  if (!result.status())
+    return parsed_view{tokens.input(), 0, 0, status::failure};
+  if (result.length() == 0)
+    return parsed_view{tokens.input(), 0, 0, status::success};
+  const token_span first = tokens[0];
+  const token_span last = tokens[result.length() - 1];
+  return parsed_view{tokens.input(), first.offset, last.offset + last.length - first.offset, status::success};
+}
+} // namespace cxl::parse
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "utility.hpp"
+
+#include <string_view>
+#include <utility>
+
+// mapping files needs the posix mmap interface, on other systems mapped_file is not defined and CXL_HAS_MAPPED_FILE
+// is left undefined, so callers can fall back to reading the input themselves
+#if defined(__has_include)
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define CXL_HAS_MAPPED_FILE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace cxl::parse
+{
+
+#if defined(CXL_HAS_MAPPED_FILE)
+// a file mapped read-only into memory, its view() is given to runtime_parse(...) and friends as one contiguous
+// string without reading it into a buffer first, pages are loaded as the parse reaches them and the kernel is told
+// the file is read front to back, so it reads ahead and drops the pages left behind
+struct mapped_file
+{
+  // at least this many zero characters follow the view, so a scan may load whole vectors past its end
+  static constexpr index_t padding = 64;
+
+  mapped_file() = default;
+
+  explicit mapped_file(const char *path)
+  {
+    const int descriptor = ::open(path, O_RDONLY);
+    if (descriptor < 0)
+      return;
+    struct stat info;
+    if (::fstat(descriptor, &info) == 0)
+      map(descriptor, static_cast<index_t>(info.st_size));
+    ::close(descriptor);
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  mapped_file(mapped_file &&other) noexcept { swap(other); }
+  mapped_file &operator=(mapped_file &&other) noexcept
+  {
+    mapped_file released{::std::move(other)};
+    swap(released);
+    return *this;
+  }
+
+  ~mapped_file()
+  {
+    if (m_mapping != nullptr)
+      ::munmap(m_mapping, static_cast<::std::size_t>(m_mapped));
+  }
+
+  // whether the file could be opened and mapped, an empty file maps to an empty view
+  bool status() const { return m_status; }
+  index_t size() const { return m_size; }
+  ::std::string_view view() const
+  {
+    return {m_mapping != nullptr ? static_cast<const char *>(m_mapping) : "", static_cast<::std::size_t>(m_size)};
+  }
+
+private:
+  // the file is mapped over a larger anonymous mapping, the rest of its last page reads as zeros and the pages
+  // after it are zeros too, so there are { padding } readable characters past the end whatever the file size
+  void map(int descriptor, index_t size)
+  {
+    if (size == 0)
+    {
+      m_status = true;
+      return;
+    }
+    const index_t page = static_cast<index_t>(::sysconf(_SC_PAGESIZE));
+    const index_t mapped = (size + padding + page - 1) / page * page;
+    void *reserved = ::mmap(nullptr, static_cast<::std::size_t>(mapped), PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED)
+      return;
+    void *file = ::mmap(reserved, static_cast<::std::size_t>(size), PROT_READ, MAP_PRIVATE | MAP_FIXED, descriptor, 0);
+    if (file == MAP_FAILED)
+    {
+      ::munmap(reserved, static_cast<::std::size_t>(mapped));
+      return;
+    }
+    ::madvise(file, static_cast<::std::size_t>(size), MADV_SEQUENTIAL);
+    ::madvise(file, static_cast<::std::size_t>(size), MADV_WILLNEED);
+    m_mapping = file;
+    m_mapped = mapped;
+    m_size = size;
+    m_status = true;
+  }
+
+  void swap(mapped_file &other) noexcept
+  {
+    ::std::swap(m_mapping, other.m_mapping);
+    ::std::swap(m_mapped, other.m_mapped);
+    ::std::swap(m_size, other.m_size);
+    ::std::swap(m_status, other.m_status);
+  }
+
+  void *m_mapping = nullptr;
+  index_t m_mapped = 0;
+  index_t m_size = 0;
+  bool m_status = false;
+};
+#endif
+} // namespace cxl::parse
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "parsed.hpp"
+#include "parsers.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cxl::parse
+{
+
+inline namespace detail
+{
+// what one chunk of a parallel_parse(...) found, the records of the chain of separators and records from { first },
+// a boundary where a separator is expected, up to { last }, the first boundary at or past the end of the chunk
+struct parallel_chunk
+{
+  index_t begin = 0;
+  index_t end = 0;
+  bool speculated = false;
+  index_t first = 0;
+  index_t last = 0;
+  ::std::vector<::std::pair<index_t, index_t>> records;
+};
+
+// the threads of a parallel_parse(...), joined however the parse is left, a thread failing to start does not
+// leave the ones already running unjoined
+struct joining_threads
+{
+  ::std::vector<::std::thread> threads;
+
+  ~joining_threads()
+  {
+    for (auto &thread : threads)
+      if (thread.joinable())
+        thread.join();
+  }
+};
+
+// follows the chain from the boundary { position } until a boundary at or past { until }, or until a separator or
+// record does not match, the offsets of every record are appended to { records }, returns the boundary reached
+template <typename RecordParser, typename SeparatorParser>
+index_t
+parse_records(::std::string_view input,
+              index_t position,
+              index_t until,
+              ::std::vector<::std::pair<index_t, index_t>> &records)
+{
+  runtime_state state{input};
+  while (position < until)
+  {
+    const index_t start = SeparatorParser{}.parse_at(state, position);
+    const index_t end = start == no_match ? no_match : RecordParser{}.parse_at(state, start);
+    if (end == no_match || end == position)
+      break;
+    records.emplace_back(start, end);
+    position = end;
+  }
+  return position;
+}
+
+// a chunk but the first one starts inside a record as likely as not, the chain is tried from the first positions
+// where a separator and a record match, the first chain reaching the end of the chunk is kept, a position inside a
+// quoted string of the grammar soon runs into its closing quote and is given up, whatever the chunk keeps is checked
+// against the records before it when the chunks are merged
+template <typename RecordParser, typename SeparatorParser>
+void
+speculate(::std::string_view input, parallel_chunk &chunk)
+{
+  constexpr int attempts = 8;
+  const index_t size = static_cast<index_t>(input.size());
+  index_t candidate = chunk.begin;
+  for (int attempt = 0; attempt < attempts && candidate < chunk.end; ++candidate)
+  {
+    chunk.records.clear();
+    const index_t last = parse_records<RecordParser, SeparatorParser>(input, candidate, chunk.end, chunk.records);
+    if (chunk.records.empty())
+      continue;
+    if (last >= chunk.end || last == size)
+    {
+      chunk.speculated = true;
+      chunk.first = candidate;
+      chunk.last = last;
+      return;
+    }
+    ++attempt;
+  }
+  chunk.records.clear();
+}
+} // namespace detail
+
+// parses { input } made of { RecordParser } matches separated by { SeparatorParser } ones, like
+// RecordParser & *(SeparatorParser & RecordParser) would, on { threads } threads, chunks of about { chunk_size }
+// characters are handed to the threads as they become free, each chunk guesses where its first record starts and
+// the guesses are checked in order, a chunk that guessed wrong is parsed again from where the one before it ended,
+// { on_record } gets a std::string_view of every record in order once all chunks are parsed
+template <typename RecordParser, typename SeparatorParser, typename OnRecord>
+parsed_view
+parallel_parse(RecordParser,
+               SeparatorParser,
+               ::std::string_view input,
+               index_t threads,
+               OnRecord &&on_record,
+               index_t chunk_size = index_t(1) << 16)
+{
+  using record_parser = decltype(simplify(RecordParser{}));
+  using separator_parser = decltype(simplify(SeparatorParser{}));
+  const index_t size = static_cast<index_t>(input.size());
+  const auto emit = [&](index_t start, index_t end) {
+    on_record(::std::string_view{input.data() + start, static_cast<::std::size_t>(end - start)});
+  };
+
+  runtime_state state{input};
+  const index_t first_end = record_parser{}.parse_at(state, 0);
+  if (first_end == no_match)
+    return parsed_view{input, 0, 0, status::failure};
+
+  // the first record is read before splitting, so every chunk starts at a boundary or inside a record
+  const index_t count = ::std::max(index_t(1), (size - first_end) / ::std::max(chunk_size, index_t(1)));
+  ::std::vector<parallel_chunk> chunks(static_cast<::std::size_t>(count));
+  for (index_t i = 0; i < count; ++i)
+  {
+    chunks[i].begin = first_end + (size - first_end) * i / count;
+    chunks[i].end = first_end + (size - first_end) * (i + 1) / count;
+  }
+
+  ::std::atomic<index_t> next{0};
+  const auto work = [&] {
+    for (index_t i = next++; i < count; i = next++)
+      speculate<record_parser, separator_parser>(input, chunks[i]);
+  };
+  {
+    joining_threads pool;
+    for (index_t i = 1; i < ::std::min(threads, count); ++i)
+      pool.threads.emplace_back(work);
+    work();
+  }
+
+  // the true chain enters every chunk at { position }, where the chunk's own chain has a boundary too the two are
+  // the same from there on, otherwise the chunk is parsed again from { position }
+  emit(0, first_end);
+  ::std::vector<::std::pair<index_t, index_t>> records;
+  index_t position = first_end;
+  for (index_t i = 0; i < count; ++i)
+  {
+    const parallel_chunk &chunk = chunks[i];
+    if (position >= chunk.end)
+      continue;
+    if (chunk.speculated && position >= chunk.first)
+    {
+      const auto joined =
+          position == chunk.first
+              ? chunk.records.begin()
+              : ::std::lower_bound(chunk.records.begin(),
+                                   chunk.records.end(),
+                                   position,
+                                   [](const ::std::pair<index_t, index_t> &record, index_t at) {
+                                     return record.second < at;
+                                   });
+      if (position == chunk.first || (joined != chunk.records.end() && joined->second == position))
+      {
+        for (auto record = position == chunk.first ? joined : joined + 1; record != chunk.records.end(); ++record)
+          emit(record->first, record->second);
+        position = chunk.last;
+        continue;
+      }
+    }
+    records.clear();
+    const index_t reached =
+        parse_records<record_parser, separator_parser>(input, position, chunk.end, records);
+    for (const auto &record : records)
+      emit(record.first, record.second);
+    if (reached < chunk.end)
+      return parsed_view{input, 0, reached, status::success};
+    position = reached;
+  }
+  return parsed_view{input, 0, position, status::success};
+}
+} // namespace cxl::parse
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+#include <string_view>
 #include <type_traits>
 
 #include "typelist.hpp"
+#include "utility.hpp"
 
 namespace cxl::parse
 {
@@ -10,16 +13,108 @@ namespace cxl::parse
 enum class status
 {
   success = 1,
-  failure = 0
+  failure = 0,
+  // a failure after a commit, the enclosing one_of gives up instead of trying its next alternative
+  committed = 2
 };
 
-template <typename Match, typename Remainder, status Status, typename ParseTree = typelist<>>
-struct parsed
+inline namespace detail
+{
+// joining the trees of two consecutive results only records both halves, so a tree of n nodes is built in
+// linear time, its nodes are collected into a single typelist once, when the tree is read
+template <typename Left, typename Right>
+struct tree_join
+{
+};
+
+template <typename... Nodes>
+struct tree_nodes
+{
+};
+
+// the helpers are class templates, function templates over whole trees would each need a symbol spelling
+// out the tree they were instantiated with
+template <typename Left, typename Right>
+struct join_trees
+{
+  using type = tree_join<Left, Right>;
+};
+
+template <typename Tree>
+struct join_trees<Tree, typelist<>>
+{
+  using type = Tree;
+};
+
+template <typename Tree>
+struct join_trees<typelist<>, Tree>
+{
+  using type = Tree;
+};
+
+template <>
+struct join_trees<typelist<>, typelist<>>
+{
+  using type = typelist<>;
+};
+
+template <typename Left, typename Right>
+struct concat_nodes;
+
+template <typename... LeftNodes, typename... RightNodes>
+struct concat_nodes<tree_nodes<LeftNodes...>, tree_nodes<RightNodes...>>
+{
+  using type = tree_nodes<LeftNodes..., RightNodes...>;
+};
+
+// collecting a join costs the size of its subtree, and the parsers join balanced blocks, so a tree of n nodes
+// is collected in O(n log n)
+template <typename Tree>
+struct collect_tree;
+
+template <typename... Nodes>
+struct collect_tree<typelist<Nodes...>>
+{
+  using type = tree_nodes<Nodes...>;
+};
+
+template <typename Left, typename Right>
+struct collect_tree<tree_join<Left, Right>>
+{
+  using type = typename concat_nodes<typename collect_tree<Left>::type, typename collect_tree<Right>::type>::type;
+};
+
+template <typename Nodes>
+struct flatten_tree;
+
+template <typename... Nodes>
+struct flatten_tree<tree_nodes<Nodes...>>
+{
+  using type = typelist<Nodes...>;
+};
+} // namespace detail
+
+inline namespace detail
+{
+// the members of a result that do not depend on its parse tree, the parsers query every intermediate result
+// through these, members of parsed<...> itself would each instantiate a symbol spelling out the whole tree
+template <typename Match, typename Remainder, status Status>
+struct parsed_state
 {
   constexpr auto match() const { return Match{}; }
   constexpr auto remainder() const { return Remainder{}; }
-  constexpr bool status() const { return (bool)Status; }
-  constexpr auto tree() const { return ParseTree{}; }
+  constexpr bool status() const { return Status == status::success; }
+  constexpr bool committed() const { return Status == status::committed; }
+};
+} // namespace detail
+
+template <typename Match, typename Remainder, status Status, typename ParseTree = typelist<>>
+struct parsed : parsed_state<Match, Remainder, Status>
+{
+  constexpr auto tree() const
+  {
+    return typename flatten_tree<typename collect_tree<ParseTree>::type>::type{};
+  }
   template <typename String>
   constexpr auto set_match(const String) const
   {
@@ -33,16 +128,82 @@ struct parsed
   template <typename Generator>
   constexpr auto generate(const Generator) const
   {
-    return parsed<Match, Remainder, Status, decltype(ParseTree{}.append(typelist<Generator>{}))>{};
+    return parsed<Match, Remainder, Status, typename join_trees<ParseTree, typelist<Generator>>::type>{};
   }
   constexpr auto fail() const { return parsed<Match, Remainder, status::failure, ParseTree>{}; }
   constexpr auto succeed() const { return parsed<Match, Remainder, status::success, ParseTree>{}; }
+  constexpr auto commit() const { return parsed<Match, Remainder, status::committed, ParseTree>{}; }
+};
+
+inline namespace detail
+{
+template <typename First, typename Second>
+struct join_parsed;
+
+template <typename M1, typename R1, auto P1, typename T1, typename M2, typename R2, auto P2, typename T2>
+struct join_parsed<parsed<M1, R1, P1, T1>, parsed<M2, R2, P2, T2>>
+{
+  using type = parsed<decltype(M1{} + M2{}), R2, P2, typename join_trees<T1, T2>::type>;
 };
+} // namespace detail
+
+// the result of { First } followed by { Second }, the parsers join their results through this alias rather than
+// operator+, which like every function template instantiates a symbol spelling out both parse trees
+template <typename First, typename Second>
+using joined = typename join_parsed<::std::remove_cv_t<First>, ::std::remove_cv_t<Second>>::type;
 
 template <typename M1, typename R1, auto P1, typename T1, typename M2, typename R2, auto P2, typename T2>
 constexpr auto
 operator+(const parsed<M1, R1, P1, T1>, const parsed<M2, R2, P2, T2>)
 {
-  return parsed<decltype(M1{} + M2{}), R2, P2, decltype(T1{}.append(T2{}))>{};
+  return joined<parsed<M1, R1, P1, T1>, parsed<M2, R2, P2, T2>>{};
 }
+
+// the runtime counterpart of parsed<...>, a match is described by its offset and length in the parsed input
+struct parsed_view
+{
+  constexpr parsed_view(::std::string_view input, index_t offset, index_t length, enum status status)
+      : m_input(input), m_offset(offset), m_length(length), m_status(status)
+  {
+  }
+
+  constexpr auto match() const { return m_input.substr(m_offset, m_length); }
+  constexpr auto remainder() const { return m_input.substr(m_offset + m_length); }
+  constexpr bool status() const { return m_status == status::success; }
+  constexpr index_t offset() const { return m_offset; }
+  constexpr index_t length() const { return m_length; }
+  constexpr ::std::string_view input() const { return m_input; }
+
+private:
+  ::std::string_view m_input;
+  index_t m_offset;
+  index_t m_length;
+  enum status m_status;
+};
+
+// the result of capture<Capacity>(...), a parsed_view that also locates what every generator matched,
+// in the order the generators started matching, only the first { Capacity } of them are kept
+template <index_t Capacity>
+struct parsed_captures : parsed_view
+{
+  constexpr parsed_captures(parsed_view result,
+                            const ::std::array<index_t, Capacity> &offsets,
+                            const ::std::array<index_t, Capacity> &lengths,
+                            index_t count)
+      : parsed_view(result), m_offsets(offsets), m_lengths(lengths), m_count(count)
+  {
+  }
+
+  constexpr index_t size() const { return m_count < Capacity ? m_count : Capacity; }
+  constexpr bool overflowed() const { return m_count > Capacity; }
+  constexpr auto operator[](index_t i) const
+  {
+    return parsed_view{input(), m_offsets[i], m_lengths[i], status::success};
+  }
+
+private:
+  ::std::array<index_t, Capacity> m_offsets;
+  ::std::array<index_t, Capacity> m_lengths;
+  index_t m_count;
+};
 } // namespace cxl::parse
\ No newline at end of file
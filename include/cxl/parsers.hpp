@@ -1,11 +1,17 @@
 #pragma once
 
+#include "automaton.hpp"
 #include "integral.hpp"
 #include "parsed.hpp"
+#include "scan.hpp"
 #include "string.hpp"
 #include "typelist.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
+#include <array>
+#include <string_view>
+
 namespace cxl::parse
 {
 
@@ -13,6 +19,10 @@ namespace cxl::parse
 template <typename TargetString>
 struct one_string;
 
+// this parser matches the longest of the given compile-time strings, sharing their common prefixes in a trie
+template <typename... TargetStrings>
+struct keywords;
+
 // this parser matches one instance of a given integral constant character
 template <typename TargetString>
 struct one_char;
@@ -62,353 +72,1781 @@ struct sequence;
 template <typename InitTargetParser, typename... TargetParsers>
 struct one_of;
 
+// this parser matches one character of the set { CharSet } describes, see range(...), intersect(...) and
+// operators | and ! below for building sets
+template <typename CharSet>
+struct char_class;
+
 // you know, don't act like you don't
 struct anything;
 
+// this parser always succeeds without consuming anything, once a sequence got past it a failure of the rest of
+// that sequence is final and the enclosing one_of does not try its remaining alternatives
+struct commit;
+
 // this is where the magic happens
 // give it a parser and an output template and you've got yourself an AST
 template <typename TargetParser, template <typename...> typename Output>
 struct generator;
 
+enum class associativity
+{
+  left,
+  right
+};
+
+constexpr auto left_associative = ::std::integral_constant<associativity, associativity::left>{};
+constexpr auto right_associative = ::std::integral_constant<associativity, associativity::right>{};
+
+// an entry of an operator_table<...>, matching { OperatorParser } between two operands binds them into an
+// { Output }<...> of the operands' and the operator's trees
+template <typename OperatorParser, index_t Precedence, associativity Associativity, template <typename...> typename Output>
+struct binary_operator;
+
+// this parser matches operands of { OperandParser } joined by the given binary_operator<...>s, resolving
+// precedence and associativity in a single precedence climbing (Pratt) loop instead of one rule per tier
+template <typename OperandParser, typename... Operators>
+struct operator_table;
+
+// this parser stands for { Tag }::definition(), which can be defined after the rule is used, so a grammar can
+// refer to itself, left recursion is not supported
+template <typename Tag>
+struct rule;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template <typename TargetString>
-struct one_string
+inline namespace detail
 {
-  using parser_tag = tag_t;
-  constexpr one_string() {}
-  constexpr one_string(TargetString) {}
+// returned by a parser's parse_at(...) when it does not match at the given position
+constexpr index_t no_match = -1;
 
-  template <typename InputString>
-  constexpr auto parse(InputString) const
-  {
-    constexpr auto target_string = TargetString{};
-    constexpr auto input_string = InputString{};
-    if constexpr (target_string.size() > input_string.size())
-    {
-      return parsed<string<>, InputString, status::failure>{};
-    }
-    else
-    {
-      constexpr index_t size_of_match = strmatch(target_string, input_string);
-      if constexpr (size_of_match == 0)
-        return parsed<string<>, InputString, status::failure>{};
-      if constexpr (size_of_match == target_string.size())
-      {
-        if constexpr (input_string.begin() + target_string.size() == input_string.end())
-          return parsed<TargetString, string<>, status::success>{};
-        else
-          return parsed<TargetString,
-                        decltype(substr(input_string.begin() + target_string.size(), input_string.end())),
-                        status::success>{};
-      }
-      else
-        return parsed<string<>, InputString, status::failure>{};
-    }
-  }
+// the state shared by every parser taking part in a runtime parse
+// it keeps the input as a plain pointer and length, so the per-character checks stay cheap when
+// a parse is evaluated during compilation
+struct runtime_state
+{
+  const char *data;
+  index_t length;
+  // set by a sequence failing after its commit, read by the enclosing one_of
+  bool committed = false;
+
+  constexpr runtime_state(::std::string_view input) : data(input.data()), length(static_cast<index_t>(input.size())) {}
 
+  constexpr index_t size() const { return length; }
+
+  // a plain runtime parse keeps no captures, so there is nothing to record or to roll back
+  constexpr index_t mark() const { return 0; }
+  constexpr index_t begin_capture() { return 0; }
   template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
+  constexpr void end_capture(index_t, index_t, index_t)
   {
-    return generator(decltype(*this){}, Output<>{});
   }
+  constexpr void rewind(index_t) {}
 
-  constexpr auto operator!() const { return filter<one_string<TargetString>>{}; }
-  constexpr auto operator~() const { return optional<one_string<TargetString>>{}; }
-  constexpr auto operator+() const { return one_or_more<one_string<TargetString>>{}; }
-  constexpr auto operator*() const { return zero_or_more<one_string<TargetString>>{}; }
+  // nor does it remember what rules matched, see memo_state<...>, or how far they looked, see reparse_state<...>
+  template <typename Rule>
+  static constexpr index_t memo_index = -1;
+  constexpr void examine(index_t) {}
+};
 
-  template <index_t I>
-  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+// the state of a capturing parse, every generator reserves a slot when it starts matching and fills it in when it
+// succeeds, a parser failing after some of its subparsers succeeded rewinds to the slot count it started with
+template <index_t Capacity>
+struct capture_state : runtime_state
+{
+  using runtime_state::runtime_state;
+
+  ::std::array<index_t, Capacity> offsets{};
+  ::std::array<index_t, Capacity> lengths{};
+  index_t count = 0;
+
+  constexpr index_t mark() const { return count; }
+  constexpr index_t begin_capture() { return count++; }
+  template <template <typename...> typename Output>
+  constexpr void end_capture(index_t slot, index_t offset, index_t length)
   {
-    return repeat<one_string<TargetString>, I>{};
+    if (slot < Capacity)
+    {
+      offsets[slot] = offset;
+      lengths[slot] = length;
+    }
   }
+  constexpr void rewind(index_t mark) { count = mark; }
 };
 
-template <typename TargetString>
-struct one_char
+// hands the text a generator of { Output } matched to { visitor }, along with an Output<> telling which one it was
+template <template <typename...> typename Output, typename Visitor>
+constexpr void
+visit_generated(Visitor &visitor, ::std::string_view text)
 {
-  using parser_tag = tag_t;
-  constexpr one_char() {}
-  constexpr one_char(TargetString) {}
+  visitor(Output<>{}, text);
+}
 
-  template <typename InputString, index_t... Indices>
-  constexpr auto parse_impl(InputString, index_range<Indices...>) const
-  {
-    constexpr auto target_string = TargetString{};
-    constexpr auto input_string = InputString{};
-    if constexpr ((false || ... || (input_string[0] == target_string[Indices])))
-      return parsed<string<input_string[0]>,
-                    decltype(substr(++input_string.begin(), input_string.end())),
-                    status::success>{};
-    else
-      return parsed<string<>, InputString, status::failure>{};
-  }
+// the state of a capturing parse that also remembers which generator filled every slot, so the captures can be
+// handed to a visitor once the parse succeeded
+template <index_t Capacity, typename Visitor>
+struct visit_state : capture_state<Capacity>
+{
+  using capture_state<Capacity>::capture_state;
 
-  template <typename InputString>
-  constexpr auto parse(InputString) const
-  {
-    constexpr auto target_string = TargetString{};
-    constexpr auto input_string = InputString{};
-    return parse_impl(input_string, make_index_range<0, target_string.size() - 1>());
-  }
+  ::std::array<void (*)(Visitor &, ::std::string_view), Capacity> visits{};
 
   template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
+  constexpr void end_capture(index_t slot, index_t offset, index_t length)
   {
-    return generator(decltype(*this){}, Output<>{});
+    capture_state<Capacity>::template end_capture<Output>(slot, offset, length);
+    if (slot < Capacity)
+      visits[slot] = &visit_generated<Output, Visitor>;
   }
+};
 
-  constexpr auto operator!() const { return filter<one_char<TargetString>>{}; }
-  constexpr auto operator~() const { return optional<one_char<TargetString>>{}; }
-  constexpr auto operator+() const { return one_or_more<one_char<TargetString>>{}; }
-  constexpr auto operator*() const { return zero_or_more<one_char<TargetString>>{}; }
+// the index of { Rule } among { Rules }, -1 when it is not one of them
+template <typename Rule, typename... Rules>
+constexpr index_t rule_index_of = [] {
+  constexpr bool same[] = {false, ::std::is_same_v<Rule, Rules>...};
+  for (index_t i = 0; i < index_t(sizeof...(Rules)); ++i)
+    if (same[i + 1])
+      return i;
+  return index_t(-1);
+}();
+
+// a remembered result of a rule at a position, { key } is 0 for an empty entry
+struct memo_entry
+{
+  index_t key = 0;
+  index_t end = 0;
+};
 
-  template <index_t I>
-  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+// the state of a memoized parse, the end of every rule of { Rules } at every position it was tried at is kept in a
+// table provided by the caller, with rules * (input size + 1) entries every result has its own entry so each rule
+// runs at most once per position, a smaller table bounds the memory used and keeps the most recent results, without
+// any entry nothing is remembered and the parse runs like runtime_parse(...)
+template <typename... Rules>
+struct memo_state : runtime_state
+{
+  // a rule that failed after a commit is remembered apart from a plain failure, the enclosing one_of needs to know
+  static constexpr index_t committed_failure = -2;
+
+  memo_entry *entries;
+  index_t capacity;
+
+  constexpr memo_state(::std::string_view input, memo_entry *entries, index_t capacity)
+      : runtime_state(input), entries(entries), capacity(capacity)
   {
-    return repeat<one_char<TargetString>, I>{};
+    for (index_t i = 0; i < capacity; ++i)
+      entries[i] = memo_entry{};
   }
-};
 
-template <typename TargetParser>
-struct before
-{
-  using parser_tag = tag_t;
-  constexpr before() {}
-  constexpr before(TargetParser) {}
+  template <typename Rule>
+  static constexpr index_t memo_index = rule_index_of<Rule, Rules...>;
 
-  template <typename InputString>
-  constexpr auto parse(InputString) const
+  template <typename Rule>
+  constexpr index_t key(index_t position) const
   {
-    constexpr auto input_string = InputString{};
-    constexpr auto result = TargetParser{}.parse(input_string);
-    if constexpr (result.status())
-      return parsed<string<>, InputString, status::success>{};
-    else
-      return parsed<decltype(result.match()), InputString, status::failure>{};
+    return position * index_t(sizeof...(Rules)) + memo_index<Rule> + 1;
   }
 
-  template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
+  // whether { Rule } was already tried at { position }, its end is then written to { end }
+  template <typename Rule>
+  constexpr bool recall(index_t position, index_t &end)
   {
-    return generator(decltype(*this){}, Output<>{});
+    if (capacity <= 0)
+      return false;
+    const index_t entry_key = key<Rule>(position);
+    const memo_entry &entry = entries[(entry_key - 1) % capacity];
+    if (entry.key != entry_key)
+      return false;
+    committed = entry.end == committed_failure;
+    end = committed ? no_match : entry.end;
+    return true;
   }
 
-  constexpr auto operator~() const { return optional<before<TargetParser>>{}; }
-  constexpr auto operator+() const { return one_or_more<before<TargetParser>>{}; }
-  constexpr auto operator*() const { return zero_or_more<before<TargetParser>>{}; }
+  // what a rule needs to save before running, and hands back to remember(...), nothing for a memoized parse
+  constexpr index_t begin_rule(index_t) { return 0; }
 
-  template <index_t I>
-  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  template <typename Rule>
+  constexpr void remember(index_t position, index_t end, index_t)
   {
-    return repeat<before<TargetParser>, I>{};
+    if (capacity <= 0)
+      return;
+    const index_t entry_key = key<Rule>(position);
+    entries[(entry_key - 1) % capacity] = memo_entry{entry_key, end == no_match && committed ? committed_failure : end};
   }
 };
 
-template <char... Chars>
-before(string<Chars...> &)->before<one_string<string<Chars...>>>;
+// a remembered result of a rule at a position of a reparse_table<...>, { length } is the length of the match or
+// negative for a failure, { examined } the number of characters the result depends on, 0 for an empty entry
+struct reparse_entry
+{
+  index_t length = 0;
+  index_t examined = 0;
+};
+} // namespace detail
 
-template <typename TargetParser>
-struct filter
+// { removed } characters at { offset } were replaced with { inserted } new ones
+struct text_edit
 {
-  using parser_tag = tag_t;
-  constexpr filter() {}
-  constexpr filter(TargetParser) {}
+  index_t offset = 0;
+  index_t removed = 0;
+  index_t inserted = 0;
+};
 
-  template <typename InputString>
-  constexpr auto parse(InputString) const
+// the results of every rule of { Rules } at every position of an input, along with how many characters each of
+// them looked at, kept between parses of successive versions of a text so reparse(...) only runs the rules an edit
+// could have changed, the entries are provided by the caller, rules * (input size + 1) of them remember every result
+// and results at positions past a smaller table are not remembered
+template <typename... Rules>
+struct reparse_table
+{
+  static_assert(sizeof...(Rules) > 0, "reparse_table<...> needs the rule<...>s to remember");
+
+  // a rule that failed after a commit is remembered apart from a plain failure, the enclosing one_of needs to know
+  static constexpr index_t committed_failure = -2;
+
+  constexpr reparse_table(reparse_entry *entries, index_t capacity, Rules...) : entries(entries), capacity(capacity)
   {
-    constexpr auto input_string = InputString{};
-    constexpr auto target_result = TargetParser{}.parse(input_string);
-    if constexpr (target_result.status())
-      return parsed<string<>, InputString, status::failure>{};
-    else
-      return parsed<string<input_string[0]>,
-                    decltype(substr(++input_string.begin(), input_string.end())),
-                    status::success>{};
+    clear();
   }
 
-  template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
+  constexpr void clear()
   {
-    return generator(decltype(*this){}, Output<>{});
+    for (index_t i = 0; i < capacity; ++i)
+      entries[i] = reparse_entry{};
   }
 
-  constexpr auto operator~() const { return optional<filter<TargetParser>>{}; }
-  constexpr auto operator+() const { return one_or_more<filter<TargetParser>>{}; }
-  constexpr auto operator*() const { return zero_or_more<filter<TargetParser>>{}; }
-
-  template <index_t I>
-  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  // forgets the results that looked at a replaced character, or at the end of the input for an insertion there, and
+  // moves those after the edit to their new positions, only as much work as moving the entries takes, the rules
+  // are run again by the next reparse(...)
+  constexpr void edit(text_edit change)
   {
-    return repeat<filter<TargetParser>, I>{};
+    constexpr index_t rules = index_t(sizeof...(Rules));
+    const index_t first = ::std::min(change.offset * rules, capacity);
+    for (index_t i = 0; i < first; ++i)
+      if (i / rules + entries[i].examined > change.offset)
+        entries[i] = reparse_entry{};
+    const index_t delta = (change.inserted - change.removed) * rules;
+    const index_t after = (change.offset + change.removed) * rules;
+    if (delta > 0)
+    {
+      for (index_t i = capacity - 1; i >= after + delta; --i)
+        entries[i] = entries[i - delta];
+    }
+    else if (delta < 0)
+    {
+      for (index_t i = after; i < capacity; ++i)
+        entries[i + delta] = entries[i];
+      for (index_t i = ::std::max(after, capacity) + delta; i < capacity; ++i)
+        entries[i] = reparse_entry{};
+    }
+    for (index_t i = first; i < ::std::min((change.offset + change.inserted) * rules, capacity); ++i)
+      entries[i] = reparse_entry{};
   }
-};
 
-template <char... Chars>
-filter(string<Chars...>)->filter<one_string<string<Chars...>>>;
+  reparse_entry *entries;
+  index_t capacity;
+};
 
-template <typename TargetParser>
-struct optional
+inline namespace detail
 {
-  using parser_tag = tag_t;
-  constexpr optional() {}
-  constexpr optional(TargetParser) {}
+// the state of a reparse, every leaf tells how far it looked so each rule knows what its result depends on
+template <typename... Rules>
+struct reparse_state : runtime_state
+{
+  reparse_table<Rules...> &table;
+  // the end of the characters looked at so far by the innermost running rule
+  index_t furthest = 0;
 
-  template <typename InputString>
-  constexpr auto parse(InputString) const
+  constexpr reparse_state(::std::string_view input, reparse_table<Rules...> &table)
+      : runtime_state(input), table(table)
   {
-    constexpr auto result = TargetParser{}.parse(InputString{});
-    if constexpr (result.status())
-      return result;
-    else
-      return parsed<string<>, InputString, status::success>{};
   }
 
-  template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
-  {
-    return generator(decltype(*this){}, Output<>{});
-  }
+  template <typename Rule>
+  static constexpr index_t memo_index = rule_index_of<Rule, Rules...>;
 
-  constexpr auto operator!() const { return filter<optional<TargetParser>>{}; }
-  constexpr auto operator+() const { return one_or_more<optional<TargetParser>>{}; }
-  constexpr auto operator*() const { return zero_or_more<optional<TargetParser>>{}; }
+  constexpr void examine(index_t end) { furthest = ::std::max(furthest, end); }
 
-  template <index_t I>
-  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  template <typename Rule>
+  constexpr bool recall(index_t position, index_t &end)
   {
-    return repeat<optional<TargetParser>, I>{};
+    const index_t index = position * index_t(sizeof...(Rules)) + memo_index<Rule>;
+    if (index >= table.capacity || table.entries[index].examined == 0)
+      return false;
+    const reparse_entry &entry = table.entries[index];
+    examine(position + entry.examined);
+    committed = entry.length == table.committed_failure;
+    end = entry.length < 0 ? no_match : position + entry.length;
+    return true;
   }
-};
-
-template <char... Chars>
-optional(string<Chars...>)->optional<one_string<string<Chars...>>>;
-
-template <typename TargetParser>
-struct one_or_more
-{
-  using parser_tag = tag_t;
-  constexpr one_or_more() {}
-  constexpr one_or_more(TargetParser) {}
 
-  template <index_t Count = 0, typename InputString>
-  constexpr auto parse(InputString) const
+  // a rule measures what it looks at on its own, then adds it to what the enclosing rule looked at
+  constexpr index_t begin_rule(index_t position)
   {
-    constexpr TargetParser target_parser;
-    constexpr InputString input_string;
-    constexpr auto result = target_parser.parse(input_string);
-    if constexpr (Count == 0)
-    {
-      if constexpr (result.status())
-        return result + parse<Count + 1>(substr(input_string.begin() + result.match().size(), input_string.end()));
-      else
-        return result;
-    }
-    else
-    {
-      if constexpr (result.status())
-        return result + parse<Count + 1>(substr(input_string.begin() + result.match().size(), input_string.end()));
-      else
-        return result.succeed();
-    }
+    const index_t saved = furthest;
+    furthest = position;
+    return saved;
   }
 
-  template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
+  template <typename Rule>
+  constexpr void remember(index_t position, index_t end, index_t saved)
   {
-    return generator(decltype(*this){}, Output<>{});
+    const index_t index = position * index_t(sizeof...(Rules)) + memo_index<Rule>;
+    if (index < table.capacity)
+      table.entries[index] = reparse_entry{end != no_match ? end - position : committed ? table.committed_failure : -1,
+                                           ::std::max(furthest - position, index_t(1))};
+    furthest = ::std::max(furthest, saved);
   }
-
-  constexpr auto operator!() const { return filter<one_or_more<TargetParser>>{}; }
-  constexpr auto operator~() const { return optional<one_or_more<TargetParser>>{}; }
 };
+} // namespace detail
 
-template <char... Chars>
-one_or_more(string<Chars...>)->one_or_more<one_string<string<Chars...>>>;
+// returns an equivalent parser that is cheaper to instantiate and to run, parsers without a simplify(...)
+// overload (see the end of this file) are already as simple as they get
+template <typename Parser>
+constexpr auto
+simplify(Parser)
+{
+  return Parser{};
+}
 
-template <typename TargetParser>
-struct zero_or_more
+inline namespace detail
 {
-  using parser_tag = tag_t;
-  constexpr zero_or_more() {}
-  constexpr zero_or_more(TargetParser) {}
+// every parse of a parser simplify(...) would change is forwarded to the simplified one
+template <typename Parser>
+constexpr bool is_simplified = ::std::is_same_v<decltype(simplify(Parser{})), Parser>;
+} // namespace detail
 
-  template <index_t Count = 0, typename InputString>
-  constexpr auto parse(InputString) const
-  {
-    constexpr TargetParser target_parser;
-    constexpr InputString input_string;
-    constexpr auto result = target_parser.parse(input_string);
+// runs { Parser } over a runtime string, the result refers into { input } so nothing is ever allocated
+template <typename Parser>
+constexpr auto
+runtime_parse(Parser, ::std::string_view input)
+{
+  runtime_state state{input};
+  const index_t end = decltype(simplify(Parser{})){}.parse_at(state, 0);
+  if (end == no_match)
+    return parsed_view{input, 0, 0, status::failure};
+  else
+    return parsed_view{input, 0, end, status::success};
+}
 
-    if constexpr (result.status())
-      return result + parse<Count + 1>(substr(input_string.begin() + result.match().size(), input_string.end()));
-    else
-      return result.succeed();
-  }
+// runs { Parser } over a runtime string like runtime_parse(...), also locating what each generator matched,
+// being plain constexpr code over the input it can validate large embedded strings during compilation
+template <index_t Capacity, typename Parser>
+constexpr auto
+capture(Parser, ::std::string_view input)
+{
+  capture_state<Capacity> state{input};
+  const index_t end = decltype(simplify(Parser{})){}.parse_at(state, 0);
+  if (end == no_match)
+    return parsed_captures<Capacity>{parsed_view{input, 0, 0, status::failure}, state.offsets, state.lengths, 0};
+  else
+    return parsed_captures<Capacity>{
+        parsed_view{input, 0, end, status::success}, state.offsets, state.lengths, state.count};
+}
 
-  template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
-  {
-    return generator(decltype(*this){}, Output<>{});
-  }
+// runs { Parser } over a runtime string like capture<...>(...), then calls { visitor } with an Output<> and a
+// std::string_view of the text every generator matched, in the order they started matching, so runtime input reaches
+// code keyed on the same output templates as the compile-time parse without copying any text or allocating, the
+// result is the one capture<...>(...) gives, when it overflowed() only the first { Capacity } matches were visited
+template <index_t Capacity, typename Parser, typename Visitor>
+constexpr auto
+runtime_generate(Parser, ::std::string_view input, Visitor &&visitor)
+{
+  visit_state<Capacity, ::std::remove_reference_t<Visitor>> state{input};
+  const index_t end = decltype(simplify(Parser{})){}.parse_at(state, 0);
+  if (end == no_match)
+    return parsed_captures<Capacity>{parsed_view{input, 0, 0, status::failure}, state.offsets, state.lengths, 0};
+  for (index_t i = 0; i < state.count && i < Capacity; ++i)
+    state.visits[i](visitor, input.substr(state.offsets[i], state.lengths[i]));
+  return parsed_captures<Capacity>{
+      parsed_view{input, 0, end, status::success}, state.offsets, state.lengths, state.count};
+}
 
-  constexpr auto operator!() const { return filter<zero_or_more<TargetParser>>{}; }
-};
+// runs { Parser } over a runtime string like runtime_parse(...), remembering the result of every rule of { Rules }
+// at every position in { entries }, so backtracking never runs one of them twice at the same position as long as
+// { capacity } is memo_capacity(...) or more, rules left out are not remembered, and neither are captures, a
+// { capacity } of 0 remembers nothing
+template <typename Parser, typename... Tags>
+constexpr auto
+memoized_parse(Parser, ::std::string_view input, memo_entry *entries, index_t capacity, rule<Tags>...)
+{
+  static_assert(sizeof...(Tags) > 0, "memoized_parse(...) needs the rule<...>s to remember");
+  memo_state<rule<Tags>...> state{input, entries, capacity};
+  const index_t end = decltype(simplify(Parser{})){}.parse_at(state, 0);
+  if (end == no_match)
+    return parsed_view{input, 0, 0, status::failure};
+  else
+    return parsed_view{input, 0, end, status::success};
+}
 
-template <char... Chars>
-zero_or_more(string<Chars...>)->zero_or_more<one_string<string<Chars...>>>;
+// runs { Parser } over the current version of a text, reusing the results of { table } from the parse of the
+// previous version, with every change since then passed to edit(...), only the rules whose result depends on a
+// changed character run again, the first reparse with a table fills it in
+template <typename Parser, typename... Rules>
+constexpr auto
+reparse(Parser, ::std::string_view input, reparse_table<Rules...> &table)
+{
+  reparse_state<Rules...> state{input, table};
+  const index_t end = decltype(simplify(Parser{})){}.parse_at(state, 0);
+  if (end == no_match)
+    return parsed_view{input, 0, 0, status::failure};
+  else
+    return parsed_view{input, 0, end, status::success};
+}
 
-//////////////////////////////////////////////////////////////
+// the table size with which a memoized parse of { input_size } characters remembers every result of { rules } rules
+constexpr index_t
+memo_capacity(index_t input_size, index_t rules)
+{
+  return (input_size + 1) * rules;
+}
 
-template <index_t U, typename T>
-struct identity
+inline namespace detail
 {
-  using type = T;
+// the sets a char_class<...> is built from, each describes its table so combining sets is plain constexpr code
+template <typename TargetString>
+struct chars_of
+{
+  static constexpr char_table table()
+  {
+    char_table result;
+    for (const char c : TargetString{}.view())
+      result.insert(c);
+    return result;
+  }
 };
 
-template <typename TargetParser, index_t I>
-struct repeat
+template <char First, char Last>
+struct chars_between
 {
-  using parser_tag = tag_t;
-  constexpr repeat() {}
-  constexpr repeat(TargetParser, ::std::integral_constant<index_t, I>) {}
-
-  template <index_t... Indices>
-  constexpr auto make_sequence(index_range<Indices...>) const
+  static constexpr char_table table()
   {
-    return sequence<decltype((Indices, TargetParser{}))...>{};
+    char_table result;
+    for (int c = static_cast<unsigned char>(First); c <= static_cast<unsigned char>(Last); ++c)
+      result.insert(static_cast<char>(c));
+    return result;
   }
+};
 
-  template <typename InputString>
-  constexpr auto parse(InputString) const
+template <typename LeftSet, typename RightSet>
+struct chars_union
+{
+  static constexpr char_table table()
   {
-    return make_sequence(make_index_range<0, I - 1>()).parse(InputString{});
+    char_table result;
+    for (int i = 0; i < 4; ++i)
+      result.bits[i] = LeftSet::table().bits[i] | RightSet::table().bits[i];
+    return result;
   }
+};
 
-  template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
+template <typename LeftSet, typename RightSet>
+struct chars_intersection
+{
+  static constexpr char_table table()
   {
-    return generator(decltype(*this){}, Output<>{});
+    char_table result;
+    for (int i = 0; i < 4; ++i)
+      result.bits[i] = LeftSet::table().bits[i] & RightSet::table().bits[i];
+    return result;
   }
+};
 
-  constexpr auto operator!() const { return filter<repeat<TargetParser, I>>{}; }
-  constexpr auto operator~() const { return optional<repeat<TargetParser, I>>{}; }
-  constexpr auto operator++(int) const { return repeat_minimum<TargetParser, I>{}; }
-  constexpr auto operator--(int) const { return repeat_maximum<TargetParser, I>{}; }
-  template <index_t J>
-  constexpr auto operator[](::std::integral_constant<index_t, J>) const
+template <typename TargetSet>
+struct chars_complement
+{
+  static constexpr char_table table()
   {
-    return repeat_range<TargetParser, I, J>{};
+    char_table result;
+    for (int i = 0; i < 4; ++i)
+      result.bits[i] = ~TargetSet::table().bits[i];
+    return result;
   }
 };
 
-template <char... Chars, index_t I>
-repeat(string<Chars...>, ::std::integral_constant<index_t, I>)->repeat<one_string<string<Chars...>>, I>;
+// every set's table is built once and shared by all the parses using it
+template <typename CharSet>
+constexpr char_table table_of = CharSet::table();
 
-//////////////////////////////////////////////////////////////
-//////////////////////////////////////////////////////////////
+template <typename CharSet>
+constexpr nibble_table nibbles_of = to_nibbles(table_of<CharSet>);
+
+// the set a single character parser matches, void for every other parser
+template <typename TargetParser>
+struct char_set_of
+{
+  using type = void;
+};
+
+template <typename CharSet>
+struct char_set_of<char_class<CharSet>>
+{
+  using type = CharSet;
+};
+
+template <typename TargetString>
+struct char_set_of<one_char<TargetString>>
+{
+  using type = chars_of<TargetString>;
+};
+
+template <char C>
+struct char_set_of<one_string<string<C>>>
+{
+  using type = chars_of<string<C>>;
+};
+
+// the strings of a keywords<...> parser merged by common prefix, node 0 is the root and a child or sibling
+// index of 0 means there is none, the children of a node are found by walking its sibling list
+template <index_t Capacity>
+struct keyword_trie
+{
+  char label[Capacity] = {};
+  bool terminal[Capacity] = {};
+  index_t first_child[Capacity] = {};
+  index_t next_sibling[Capacity] = {};
+  index_t size = 1;
+
+  constexpr index_t child(index_t node, char c) const
+  {
+    index_t result = first_child[node];
+    while (result != 0 && label[result] != c)
+      result = next_sibling[result];
+    return result;
+  }
+
+  constexpr void insert(::std::string_view word)
+  {
+    index_t node = 0;
+    for (const char c : word)
+    {
+      index_t next = child(node, c);
+      if (next == 0)
+      {
+        next = size++;
+        label[next] = c;
+        next_sibling[next] = first_child[node];
+        first_child[node] = next;
+      }
+      node = next;
+    }
+    terminal[node] = true;
+  }
+
+  // a single descent, remembering the end of the last complete word on the way down
+  constexpr index_t match(const char *data, index_t position, index_t size) const
+  {
+    index_t end = terminal[0] ? position : no_match;
+    for (index_t node = 0; position < size; ++position)
+    {
+      node = child(node, data[position]);
+      if (node == 0)
+        break;
+      if (terminal[node])
+        end = position + 1;
+    }
+    return end;
+  }
+};
+
+template <typename... TargetStrings>
+constexpr auto
+make_keyword_trie()
+{
+  keyword_trie<(index_t(1) + ... + index_t(TargetStrings{}.size()))> result;
+  (result.insert(TargetStrings{}.view()), ...);
+  return result;
+}
+
+template <typename... TargetStrings>
+constexpr auto keyword_trie_of = make_keyword_trie<TargetStrings...>();
+
+// the characters a parser's match can start with, a parser which may succeed without consuming one of them
+// (or at the end of the input) is { empty }, it must always be tried
+struct first_set
+{
+  char_table chars;
+  bool empty = false;
+
+  constexpr bool admits(::std::string_view remainder) const
+  {
+    return empty || (!remainder.empty() && chars.contains(remainder.front()));
+  }
+};
+
+// parsers the analysis knows nothing about could start with anything
+template <typename Parser>
+constexpr first_set
+first_of(Parser)
+{
+  first_set result{chars_complement<chars_of<string<>>>::table(), true};
+  return result;
+}
+
+template <typename TargetString>
+constexpr first_set
+first_of(one_string<TargetString>)
+{
+  constexpr auto target = TargetString{}.view();
+  first_set result;
+  if (target.empty())
+    result.empty = true;
+  else
+    result.chars.insert(target.front());
+  return result;
+}
+
+template <typename... TargetStrings>
+constexpr first_set
+first_of(keywords<TargetStrings...>)
+{
+  const first_set parts[] = {first_of(one_string<TargetStrings>{})...};
+  first_set result;
+  for (const first_set &part : parts)
+  {
+    result.chars.insert(part.chars);
+    result.empty = result.empty || part.empty;
+  }
+  return result;
+}
+
+template <typename TargetString>
+constexpr first_set
+first_of(one_char<TargetString>)
+{
+  return first_set{table_of<chars_of<TargetString>>, false};
+}
+
+template <typename CharSet>
+constexpr first_set
+first_of(char_class<CharSet>)
+{
+  return first_set{table_of<CharSet>, false};
+}
+
+// a lookahead only succeeds where its target does, even though it consumes nothing
+template <typename TargetParser>
+constexpr first_set
+first_of(before<TargetParser>)
+{
+  return first_of(TargetParser{});
+}
+
+template <typename TargetParser>
+constexpr first_set
+first_of(filter<TargetParser>)
+{
+  return first_set{chars_complement<chars_of<string<>>>::table(), false};
+}
+
+template <typename TargetParser>
+constexpr first_set
+optional_first_of(TargetParser)
+{
+  first_set result = first_of(TargetParser{});
+  result.empty = true;
+  return result;
+}
+
+template <typename TargetParser>
+constexpr first_set
+first_of(optional<TargetParser>)
+{
+  return optional_first_of(TargetParser{});
+}
+
+template <typename TargetParser>
+constexpr first_set
+first_of(zero_or_more<TargetParser>)
+{
+  return optional_first_of(TargetParser{});
+}
+
+template <typename TargetParser, index_t I>
+constexpr first_set
+first_of(repeat_maximum<TargetParser, I>)
+{
+  return optional_first_of(TargetParser{});
+}
+
+// no occurence at all is a success for repeat_range<...> too
+template <typename TargetParser, index_t Min, index_t Max>
+constexpr first_set
+first_of(repeat_range<TargetParser, Min, Max>)
+{
+  return optional_first_of(TargetParser{});
+}
+
+template <typename TargetParser>
+constexpr first_set
+first_of(one_or_more<TargetParser>)
+{
+  return first_of(TargetParser{});
+}
+
+template <typename TargetParser, index_t I>
+constexpr first_set
+first_of(repeat<TargetParser, I>)
+{
+  return I > 0 ? first_of(TargetParser{}) : optional_first_of(TargetParser{});
+}
+
+template <typename TargetParser, index_t I>
+constexpr first_set
+first_of(repeat_minimum<TargetParser, I>)
+{
+  return I > 0 ? first_of(TargetParser{}) : optional_first_of(TargetParser{});
+}
+
+// a sequence starts with its first part, and with the next one for as long as the previous ones may be empty
+template <typename... TargetParsers>
+constexpr first_set
+first_of(sequence<TargetParsers...>)
+{
+  const first_set parts[] = {first_of(TargetParsers{})...};
+  first_set result;
+  result.empty = true;
+  for (const first_set &part : parts)
+  {
+    if (!result.empty)
+      break;
+    result.chars.insert(part.chars);
+    result.empty = part.empty;
+  }
+  return result;
+}
+
+template <typename... TargetParsers>
+constexpr first_set
+first_of(one_of<TargetParsers...>)
+{
+  const first_set parts[] = {first_of(TargetParsers{})...};
+  first_set result;
+  for (const first_set &part : parts)
+  {
+    result.chars.insert(part.chars);
+    result.empty = result.empty || part.empty;
+  }
+  return result;
+}
+
+template <typename OperandParser, typename... Operators>
+constexpr first_set
+first_of(operator_table<OperandParser, Operators...>)
+{
+  return first_of(OperandParser{});
+}
+
+template <typename TargetParser, template <typename...> typename Output>
+constexpr first_set
+first_of(generator<TargetParser, Output>)
+{
+  return first_of(TargetParser{});
+}
+
+template <typename Parser>
+constexpr first_set first_set_of = first_of(Parser{});
+
+// a parser is regular when it is built from characters, strings, sequences, choices and repetitions, and every
+// choice it makes is decided by the next character alone, so it matches exactly the longest prefix of its language
+// and a dfa can run it, { follow } holds the characters that may come next within the outermost regular parser
+template <typename Parser>
+constexpr bool
+regular_before(Parser, const char_table &)
+{
+  return false;
+}
+
+template <typename TargetString>
+constexpr bool
+regular_before(one_string<TargetString>, const char_table &)
+{
+  return true;
+}
+
+template <typename TargetString>
+constexpr bool
+regular_before(one_char<TargetString>, const char_table &)
+{
+  return true;
+}
+
+template <typename CharSet>
+constexpr bool
+regular_before(char_class<CharSet>, const char_table &)
+{
+  return true;
+}
+
+// an optional parser is skipped exactly when the next character cannot start it
+template <typename TargetParser>
+constexpr bool
+regular_before(optional<TargetParser>, const char_table &follow)
+{
+  return !first_set_of<TargetParser>.chars.intersects(follow) && regular_before(TargetParser{}, follow);
+}
+
+// a repetition stops exactly when the next character cannot start another occurence, none of which may be empty
+template <typename TargetParser>
+constexpr bool
+regular_repetition(const char_table &follow)
+{
+  constexpr first_set target = first_set_of<TargetParser>;
+  char_table target_follow = follow;
+  target_follow.insert(target.chars);
+  return !target.empty && !target.chars.intersects(follow) && regular_before(TargetParser{}, target_follow);
+}
+
+template <typename TargetParser>
+constexpr bool
+regular_before(zero_or_more<TargetParser>, const char_table &follow)
+{
+  return regular_repetition<TargetParser>(follow);
+}
+
+template <typename TargetParser>
+constexpr bool
+regular_before(one_or_more<TargetParser>, const char_table &follow)
+{
+  return regular_repetition<TargetParser>(follow);
+}
+
+template <typename TargetParser, index_t I>
+constexpr bool
+regular_before(repeat_minimum<TargetParser, I>, const char_table &follow)
+{
+  return regular_repetition<TargetParser>(follow);
+}
+
+template <typename TargetParser, index_t I>
+constexpr bool
+regular_before(repeat<TargetParser, I>, const char_table &follow)
+{
+  constexpr first_set target = first_set_of<TargetParser>;
+  char_table target_follow = follow;
+  if (I > 1)
+    target_follow.insert(target.chars);
+  return (I <= 1 || !target.empty) && regular_before(TargetParser{}, target_follow);
+}
+
+template <typename Part, typename... Rest>
+constexpr bool
+regular_sequence(const char_table &follow)
+{
+  if constexpr (sizeof...(Rest) == 0)
+    return regular_before(Part{}, follow);
+  else
+  {
+    constexpr first_set rest = first_set_of<sequence<Rest...>>;
+    char_table part_follow = rest.chars;
+    if (rest.empty)
+      part_follow.insert(follow);
+    return regular_before(Part{}, part_follow) && regular_sequence<Rest...>(follow);
+  }
+}
+
+template <typename... TargetParsers>
+constexpr bool
+regular_before(sequence<TargetParsers...>, const char_table &follow)
+{
+  return regular_sequence<TargetParsers...>(follow);
+}
+
+template <typename... TargetParsers>
+constexpr bool
+longest_choice();
+
+// the alternatives start with different characters and only the last may match empty, in which case none of
+// them may start with what follows, with nothing following the alternatives may overlap as long as the first
+// of them that matches also matches the longest
+template <typename... TargetParsers>
+constexpr bool
+regular_before(one_of<TargetParsers...>, const char_table &follow)
+{
+  const first_set parts[] = {first_set_of<TargetParsers>...};
+  const bool regular[] = {regular_before(TargetParsers{}, follow)...};
+  constexpr index_t count = sizeof...(TargetParsers);
+  char_table seen;
+  bool decided = true;
+  for (index_t i = 0; i < count; ++i)
+  {
+    if (!regular[i])
+      return false;
+    decided = decided && !parts[i].chars.intersects(seen) && (!parts[i].empty || i + 1 == count);
+    seen.insert(parts[i].chars);
+  }
+  if (decided && (!parts[count - 1].empty || !seen.intersects(follow)))
+    return true;
+  return follow.empty() && longest_choice<TargetParsers...>();
+}
+
+// the thompson construction of a regular parser, each overload adds the states matching its parser from { from }
+// on and returns the state reached after a match
+template <typename TargetString>
+constexpr index_t
+add_nfa(one_string<TargetString>, nfa &automaton, index_t from)
+{
+  for (const char c : TargetString{}.view())
+  {
+    char_table set;
+    set.insert(c);
+    from = automaton.add_chars(from, set);
+  }
+  return from;
+}
+
+template <typename TargetString>
+constexpr index_t
+add_nfa(one_char<TargetString>, nfa &automaton, index_t from)
+{
+  return automaton.add_chars(from, table_of<chars_of<TargetString>>);
+}
+
+template <typename CharSet>
+constexpr index_t
+add_nfa(char_class<CharSet>, nfa &automaton, index_t from)
+{
+  return automaton.add_chars(from, table_of<CharSet>);
+}
+
+template <typename TargetParser>
+constexpr index_t
+add_nfa(optional<TargetParser>, nfa &automaton, index_t from)
+{
+  const index_t start = automaton.add_state();
+  const index_t end = add_nfa(TargetParser{}, automaton, start);
+  const index_t to = automaton.add_state();
+  automaton.add_empty(from, start);
+  automaton.add_empty(from, to);
+  automaton.add_empty(end, to);
+  return to;
+}
+
+template <typename TargetParser>
+constexpr index_t
+add_nfa(one_or_more<TargetParser>, nfa &automaton, index_t from)
+{
+  const index_t start = automaton.add_state();
+  const index_t end = add_nfa(TargetParser{}, automaton, start);
+  const index_t to = automaton.add_state();
+  automaton.add_empty(from, start);
+  automaton.add_empty(end, start);
+  automaton.add_empty(end, to);
+  return to;
+}
+
+template <typename TargetParser>
+constexpr index_t
+add_nfa(zero_or_more<TargetParser>, nfa &automaton, index_t from)
+{
+  return add_nfa(optional<one_or_more<TargetParser>>{}, automaton, from);
+}
+
+template <typename TargetParser, index_t I>
+constexpr index_t
+add_nfa(repeat<TargetParser, I>, nfa &automaton, index_t from)
+{
+  for (index_t count = 0; count < I && !automaton.overflowed; ++count)
+    from = add_nfa(TargetParser{}, automaton, from);
+  return from;
+}
+
+template <typename TargetParser, index_t I>
+constexpr index_t
+add_nfa(repeat_minimum<TargetParser, I>, nfa &automaton, index_t from)
+{
+  return add_nfa(zero_or_more<TargetParser>{}, automaton, add_nfa(repeat<TargetParser, I>{}, automaton, from));
+}
+
+template <typename... TargetParsers>
+constexpr index_t
+add_nfa(sequence<TargetParsers...>, nfa &automaton, index_t from)
+{
+  ((from = add_nfa(TargetParsers{}, automaton, from)), ...);
+  return from;
+}
+
+// every alternative but the last is entered from its own split state, the last one from the final split
+template <typename Alternative, typename... Rest>
+constexpr void
+add_alternatives(nfa &automaton, index_t split, index_t to)
+{
+  if constexpr (sizeof...(Rest) == 0)
+    automaton.add_empty(add_nfa(Alternative{}, automaton, split), to);
+  else
+  {
+    const index_t start = automaton.add_state();
+    const index_t next_split = automaton.add_state();
+    automaton.add_empty(split, start);
+    automaton.add_empty(split, next_split);
+    automaton.add_empty(add_nfa(Alternative{}, automaton, start), to);
+    add_alternatives<Rest...>(automaton, next_split, to);
+  }
+}
+
+template <typename... TargetParsers>
+constexpr index_t
+add_nfa(one_of<TargetParsers...>, nfa &automaton, index_t from)
+{
+  const index_t to = automaton.add_state();
+  add_alternatives<TargetParsers...>(automaton, from, to);
+  return to;
+}
+
+template <typename Parser>
+constexpr dfa_build
+make_dfa()
+{
+  nfa automaton;
+  const index_t start = automaton.add_state();
+  const index_t final = add_nfa(Parser{}, automaton, start);
+  return minimize(determinize(automaton, start, final));
+}
+
+template <typename Parser>
+constexpr dfa_build dfa_build_of = make_dfa<Parser>();
+
+// an ordered choice stops at the first alternative that matches, which is its longest match only when no later
+// alternative matches a string that the earlier one does not, but a prefix of which it does
+constexpr bool
+overtakes(const dfa_build &earlier, const dfa_build &later)
+{
+  constexpr index_t states = dfa_build::max_states;
+  bool visited[states][states][2] = {};
+  index_t pending[states * states * 2][3] = {};
+  index_t count = 0;
+  visited[earlier.start][later.start][0] = true;
+  pending[count][0] = earlier.start;
+  pending[count][1] = later.start;
+  pending[count++][2] = 0;
+  while (count > 0)
+  {
+    --count;
+    const index_t first = pending[count][0];
+    const index_t second = pending[count][1];
+    const bool extended = pending[count][2];
+    if (extended && later.accepting[second] && !earlier.accepting[first])
+      return true;
+    const bool next_extended = extended || earlier.accepting[first];
+    for (int c = 0; c < 256; ++c)
+    {
+      const index_t next_first = earlier.next[first][earlier.class_of[c]];
+      const index_t next_second = later.next[second][later.class_of[c]];
+      if (next_second != 0 && !visited[next_first][next_second][next_extended])
+      {
+        visited[next_first][next_second][next_extended] = true;
+        pending[count][0] = next_first;
+        pending[count][1] = next_second;
+        pending[count++][2] = next_extended;
+      }
+    }
+  }
+  return false;
+}
+
+template <typename... TargetParsers>
+constexpr bool
+longest_choice()
+{
+  if constexpr (!(regular_before(TargetParsers{}, char_table{}) && ...))
+    return false;
+  else
+  {
+    const dfa_build *automata[] = {&dfa_build_of<TargetParsers>...};
+    constexpr index_t count = sizeof...(TargetParsers);
+    for (index_t i = 0; i < count; ++i)
+      if (automata[i]->overflowed)
+        return false;
+    for (index_t i = 0; i < count; ++i)
+      for (index_t j = i + 1; j < count; ++j)
+        if (overtakes(*automata[i], *automata[j]))
+          return false;
+    return true;
+  }
+}
+
+// the automaton is only built for regular parsers, and only used when it fits the table capacity
+template <typename Parser>
+constexpr bool
+fits_dfa()
+{
+  if constexpr (!regular_before(Parser{}, char_table{}))
+    return false;
+  else
+    return !dfa_build_of<Parser>.overflowed;
+}
+
+// a regular parser combining other parsers matches with one table lookup per character
+template <typename Parser>
+constexpr bool runs_as_dfa = fits_dfa<Parser>();
+
+template <typename Parser>
+constexpr auto dfa_of = compact<dfa_build_of<Parser>.states>(dfa_build_of<Parser>);
+
+// runs the table of { Parser } from parse_at(...), telling the state how far it looked
+template <typename Parser, typename State>
+constexpr index_t
+match_dfa(State &state, index_t position)
+{
+  index_t examined = position;
+  const index_t end = dfa_of<Parser>.match(state.data, position, state.size(), examined);
+  state.examine(examined);
+  return end;
+}
+
+// the node a generator makes of the trees its target generated
+template <template <typename...> typename Output, typename... Children>
+constexpr auto
+apply_output(typelist<Children...>)
+{
+  return Output<Children...>{};
+}
+
+// the rest of a sequence failing after a commit is a committed failure
+template <typename Part, typename Result>
+struct after_part
+{
+  using type = Result;
+};
+
+template <typename Result>
+struct after_part<commit, Result>
+{
+  using type = ::std::conditional_t<Result{}.status(), Result, decltype(Result{}.commit())>;
+};
+
+// for every lookahead character, one bit per alternative of a one_of<...> that may match starting with it
+struct prediction_table
+{
+  ::std::uint64_t viable[256] = {};
+  ::std::uint64_t at_end = 0;
+};
+
+template <typename... TargetParsers>
+constexpr prediction_table
+predict()
+{
+  const first_set parts[] = {first_set_of<TargetParsers>...};
+  prediction_table result;
+  for (index_t i = 0; i < index_t(sizeof...(TargetParsers)); ++i)
+  {
+    const ::std::uint64_t bit = ::std::uint64_t(1) << i;
+    for (int c = 0; c < 256; ++c)
+      if (parts[i].empty || parts[i].chars.contains(static_cast<char>(c)))
+        result.viable[c] |= bit;
+    if (parts[i].empty)
+      result.at_end |= bit;
+  }
+  return result;
+}
+
+template <typename... TargetParsers>
+constexpr prediction_table prediction_table_of = predict<TargetParsers...>();
+
+// compile-time parsers work on slices of the string given to the outermost parse(...), so matches and
+// remainders are just offsets into it instead of new strings
+template <char... Chars>
+constexpr auto
+as_slice(string<Chars...>)
+{
+  return slice<0, sizeof...(Chars)>(string<Chars...>{});
+}
+
+template <typename Source, index_t Begin, index_t End>
+constexpr auto
+as_slice(string_slice<Source, Begin, End>)
+{
+  return string_slice<Source, Begin, End>{};
+}
+
+// whether { InputString } is a string known during compilation, only these pick the parse(...) overloads working on
+// types, a std::string, a const char * or anything else converting to a std::string_view is parsed at runtime
+template <typename InputString>
+constexpr bool is_compile_time_string = false;
+
+template <char... Chars>
+constexpr bool is_compile_time_string<string<Chars...>> = true;
+
+template <typename Source, index_t Begin, index_t End>
+constexpr bool is_compile_time_string<string_slice<Source, Begin, End>> = true;
+
+template <typename InputString>
+using if_compile_time_string = ::std::enable_if_t<is_compile_time_string<InputString>>;
+
+// the first { Count } characters of a slice
+template <index_t Count, typename Slice>
+constexpr auto
+take(Slice)
+{
+  return slice<0, Count>(Slice{});
+}
+
+// everything after the first { Count } characters of a slice
+template <index_t Count, typename Slice>
+constexpr auto
+drop(Slice)
+{
+  return slice<Count, Slice{}.size()>(Slice{});
+}
+
+// matches exactly 2^{ Exponent } consecutive occurences of { TargetParser }, as two halves of 2^{ Exponent - 1 },
+// so the instantiation depth only grows with { Exponent } and a half parsed at the same offset is reused
+template <typename TargetParser, index_t Exponent, typename Input>
+constexpr auto
+parse_block(Input)
+{
+  if constexpr (Exponent == 0)
+    return TargetParser{}.parse(Input{});
+  else
+  {
+    constexpr auto first_half = parse_block<TargetParser, Exponent - 1>(Input{});
+    if constexpr (first_half.status())
+      return joined<decltype(first_half), decltype(parse_block<TargetParser, Exponent - 1>(first_half.remainder()))>{};
+    else
+      return first_half;
+  }
+}
+
+// matches exactly { Count } consecutive occurences of { TargetParser }, one block per set bit of { Count }
+template <typename TargetParser, index_t Count, typename Input>
+constexpr auto
+parse_count(Input)
+{
+  if constexpr (Count == 0)
+    return parsed<decltype(take<0>(Input{})), Input, status::success>{};
+  else
+  {
+    constexpr index_t exponent = [] {
+      index_t result = 0;
+      while ((Count >> (result + 1)) != 0)
+        ++result;
+      return result;
+    }();
+    constexpr auto block = parse_block<TargetParser, exponent>(Input{});
+    if constexpr (block.status())
+      return joined<decltype(block),
+                    decltype(parse_count<TargetParser, Count - (index_t(1) << exponent)>(block.remainder()))>{};
+    else
+      return block;
+  }
+}
+
+// the tail of a greedy repetition: after a block of 2^{ Exponent + 1 } failed, fewer occurences than that remain,
+// trying every smaller block once from largest to smallest matches exactly as many of them as there are
+template <typename TargetParser, index_t Exponent, typename Input>
+constexpr auto
+parse_greedy_shrink(Input)
+{
+  if constexpr (Exponent < 0)
+    return parsed<decltype(take<0>(Input{})), Input, status::success>{};
+  else
+  {
+    constexpr auto block = parse_block<TargetParser, Exponent>(Input{});
+    if constexpr (block.status() && block.match().size() > 0)
+      return joined<decltype(block), decltype(parse_greedy_shrink<TargetParser, Exponent - 1>(block.remainder()))>{};
+    else
+      return parse_greedy_shrink<TargetParser, Exponent - 1>(Input{});
+  }
+}
+
+// matches as many consecutive occurences of { TargetParser } as possible, taking blocks of 1, 2, 4, ... occurences
+// while they match, so N occurences only nest O(log N) instantiations deep
+template <typename TargetParser, index_t Exponent, typename Input>
+constexpr auto
+parse_greedy(Input)
+{
+  constexpr auto block = parse_block<TargetParser, Exponent>(Input{});
+  if constexpr (block.status() && block.match().size() > 0)
+    return joined<decltype(block), decltype(parse_greedy<TargetParser, Exponent + 1>(block.remainder()))>{};
+  else
+    return parse_greedy_shrink<TargetParser, Exponent - 1>(Input{});
+}
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename TargetString>
+struct one_string
+{
+  using parser_tag = tag_t;
+  constexpr one_string() {}
+  constexpr one_string(TargetString) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    constexpr auto target_string = TargetString{};
+    constexpr auto input_string = as_slice(InputString{});
+    constexpr index_t size_of_match = strmatch(target_string, input_string);
+    if constexpr (size_of_match > 0 && size_of_match == target_string.size())
+      return parsed<decltype(take<size_of_match>(input_string)),
+                    decltype(drop<size_of_match>(input_string)),
+                    status::success>{};
+    else
+      return parsed<decltype(take<0>(input_string)), decltype(input_string), status::failure>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(one_string<TargetString>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    constexpr auto target = TargetString{}.view();
+    const index_t size = static_cast<index_t>(target.size());
+    state.examine(::std::min(position + size, state.size() + 1));
+    if (size > state.size() - position)
+      return no_match;
+    for (index_t i = 0; i < size; ++i)
+      if (state.data[position + i] != target[i])
+        return no_match;
+    return position + size;
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<one_string<TargetString>>{}; }
+  constexpr auto operator~() const { return optional<one_string<TargetString>>{}; }
+  constexpr auto operator+() const { return one_or_more<one_string<TargetString>>{}; }
+  constexpr auto operator*() const { return zero_or_more<one_string<TargetString>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<one_string<TargetString>, I>{};
+  }
+};
+
+template <typename... TargetStrings>
+struct keywords
+{
+  using parser_tag = tag_t;
+  constexpr keywords() {}
+  constexpr keywords(TargetStrings...) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    constexpr auto input_string = as_slice(InputString{});
+    constexpr auto input = input_string.view();
+    constexpr index_t end =
+        keyword_trie_of<TargetStrings...>.match(input.data(), 0, static_cast<index_t>(input.size()));
+    if constexpr (end == no_match)
+      return parsed<decltype(take<0>(input_string)), decltype(input_string), status::failure>{};
+    else
+      return parsed<decltype(take<end>(input_string)), decltype(drop<end>(input_string)), status::success>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(keywords<TargetStrings...>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    state.examine(::std::min(position + ::std::max({index_t(TargetStrings{}.size())...}), state.size() + 1));
+    return keyword_trie_of<TargetStrings...>.match(state.data, position, state.size());
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<keywords<TargetStrings...>>{}; }
+  constexpr auto operator~() const { return optional<keywords<TargetStrings...>>{}; }
+  constexpr auto operator+() const { return one_or_more<keywords<TargetStrings...>>{}; }
+  constexpr auto operator*() const { return zero_or_more<keywords<TargetStrings...>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<keywords<TargetStrings...>, I>{};
+  }
+};
+
+template <typename TargetString>
+struct one_char
+{
+  using parser_tag = tag_t;
+  constexpr one_char() {}
+  constexpr one_char(TargetString) {}
+
+  // a one_char<...> is the char_class<...> of its target's characters
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    return char_class<chars_of<TargetString>>{}.parse(InputString{});
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(one_char<TargetString>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    return char_class<chars_of<TargetString>>{}.parse_at(state, position);
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return char_class<chars_complement<chars_of<TargetString>>>{}; }
+  constexpr auto operator~() const { return optional<one_char<TargetString>>{}; }
+  constexpr auto operator+() const { return one_or_more<one_char<TargetString>>{}; }
+  constexpr auto operator*() const { return zero_or_more<one_char<TargetString>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<one_char<TargetString>, I>{};
+  }
+};
+
+template <typename TargetParser>
+struct before
+{
+  using parser_tag = tag_t;
+  constexpr before() {}
+  constexpr before(TargetParser) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    constexpr auto input_string = as_slice(InputString{});
+    constexpr auto result = TargetParser{}.parse(input_string);
+    if constexpr (result.status())
+      return parsed<decltype(take<0>(input_string)), decltype(input_string), status::success>{};
+    else
+      return parsed<decltype(result.match()), decltype(input_string), status::failure>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(before<TargetParser>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    const index_t mark = state.mark();
+    const index_t end = TargetParser{}.parse_at(state, position);
+    state.rewind(mark);
+    state.committed = false;
+    return end != no_match ? position : no_match;
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator~() const { return optional<before<TargetParser>>{}; }
+  constexpr auto operator+() const { return one_or_more<before<TargetParser>>{}; }
+  constexpr auto operator*() const { return zero_or_more<before<TargetParser>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<before<TargetParser>, I>{};
+  }
+};
+
+template <char... Chars>
+before(string<Chars...> &)->before<one_string<string<Chars...>>>;
+
+template <typename TargetParser>
+struct filter
+{
+  using parser_tag = tag_t;
+  constexpr filter() {}
+  constexpr filter(TargetParser) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    if constexpr (!is_simplified<filter<TargetParser>>)
+      return simplify(filter<TargetParser>{}).parse(InputString{});
+    else
+    {
+      constexpr auto input_string = as_slice(InputString{});
+      constexpr auto target_result = TargetParser{}.parse(input_string);
+      if constexpr (target_result.status() || input_string.size() == 0)
+        return parsed<decltype(take<0>(input_string)), decltype(input_string), status::failure>{};
+      else
+        return parsed<decltype(take<1>(input_string)), decltype(drop<1>(input_string)), status::success>{};
+    }
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(filter<TargetParser>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    state.examine(position + 1);
+    if (position >= state.size())
+      return no_match;
+    const index_t mark = state.mark();
+    const index_t end = TargetParser{}.parse_at(state, position);
+    state.rewind(mark);
+    state.committed = false;
+    return end == no_match ? position + 1 : no_match;
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator~() const { return optional<filter<TargetParser>>{}; }
+  constexpr auto operator+() const { return one_or_more<filter<TargetParser>>{}; }
+  constexpr auto operator*() const { return zero_or_more<filter<TargetParser>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<filter<TargetParser>, I>{};
+  }
+};
+
+template <char... Chars>
+filter(string<Chars...>)->filter<one_string<string<Chars...>>>;
+
+template <typename TargetParser>
+struct optional
+{
+  using parser_tag = tag_t;
+  constexpr optional() {}
+  constexpr optional(TargetParser) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    if constexpr (!is_simplified<optional<TargetParser>>)
+      return simplify(optional<TargetParser>{}).parse(InputString{});
+    else
+    {
+      constexpr auto input_string = as_slice(InputString{});
+      constexpr auto result = TargetParser{}.parse(input_string);
+      if constexpr (result.status())
+        return result;
+      else
+        return parsed<decltype(take<0>(input_string)), decltype(input_string), status::success>{};
+    }
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(optional<TargetParser>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    if constexpr (runs_as_dfa<optional<TargetParser>>)
+      return match_dfa<optional<TargetParser>>(state, position);
+    else
+    {
+      const index_t end = TargetParser{}.parse_at(state, position);
+      return end == no_match ? position : end;
+    }
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<optional<TargetParser>>{}; }
+  constexpr auto operator+() const { return one_or_more<optional<TargetParser>>{}; }
+  constexpr auto operator*() const { return zero_or_more<optional<TargetParser>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<optional<TargetParser>, I>{};
+  }
+};
+
+template <char... Chars>
+optional(string<Chars...>)->optional<one_string<string<Chars...>>>;
+
+template <typename TargetParser>
+struct one_or_more
+{
+  using parser_tag = tag_t;
+  constexpr one_or_more() {}
+  constexpr one_or_more(TargetParser) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    if constexpr (!is_simplified<one_or_more<TargetParser>>)
+      return simplify(one_or_more<TargetParser>{}).parse(InputString{});
+    else
+    {
+      constexpr auto input_string = as_slice(InputString{});
+      constexpr auto result = TargetParser{}.parse(input_string);
+      if constexpr (result.status())
+        return joined<decltype(result), decltype(zero_or_more<TargetParser>{}.parse(result.remainder()))>{};
+      else
+        return result;
+    }
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(one_or_more<TargetParser>{}, input); }
+
+  // a run of single characters is left to the scan of zero_or_more<...>
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    if constexpr (::std::is_void_v<typename char_set_of<TargetParser>::type> &&
+                  runs_as_dfa<one_or_more<TargetParser>>)
+      return match_dfa<one_or_more<TargetParser>>(state, position);
+    else
+    {
+      const index_t first = TargetParser{}.parse_at(state, position);
+      if (first == no_match)
+        return no_match;
+      else
+        return zero_or_more<TargetParser>{}.parse_at(state, first);
+    }
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<one_or_more<TargetParser>>{}; }
+  constexpr auto operator~() const { return optional<one_or_more<TargetParser>>{}; }
+};
+
+template <char... Chars>
+one_or_more(string<Chars...>)->one_or_more<one_string<string<Chars...>>>;
+
+template <typename TargetParser>
+struct zero_or_more
+{
+  using parser_tag = tag_t;
+  constexpr zero_or_more() {}
+  constexpr zero_or_more(TargetParser) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    if constexpr (!is_simplified<zero_or_more<TargetParser>>)
+      return simplify(zero_or_more<TargetParser>{}).parse(InputString{});
+    else
+    {
+      return parse_greedy<TargetParser, 0>(as_slice(InputString{}));
+    }
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(zero_or_more<TargetParser>{}, input); }
+
+  // stops on the first match that does not consume anything, so nullable targets cannot loop forever
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    // a run of single characters is consumed in one scan instead of one parse per character
+    using char_set = typename char_set_of<TargetParser>::type;
+    if constexpr (!::std::is_void_v<char_set>)
+    {
+      const index_t end = scan(table_of<char_set>, nibbles_of<char_set>, state.data, position, state.size());
+      state.examine(end + 1);
+      return end;
+    }
+    else if constexpr (runs_as_dfa<zero_or_more<TargetParser>>)
+      return match_dfa<zero_or_more<TargetParser>>(state, position);
+    else
+    {
+      for (index_t end = TargetParser{}.parse_at(state, position); end != no_match && end != position;
+           end = TargetParser{}.parse_at(state, position))
+        position = end;
+      return position;
+    }
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<zero_or_more<TargetParser>>{}; }
+};
+
+template <char... Chars>
+zero_or_more(string<Chars...>)->zero_or_more<one_string<string<Chars...>>>;
+
+//////////////////////////////////////////////////////////////
+
+template <index_t U, typename T>
+struct identity
+{
+  using type = T;
+};
+
+template <typename TargetParser, index_t I>
+struct repeat
+{
+  using parser_tag = tag_t;
+  constexpr repeat() {}
+  constexpr repeat(TargetParser, ::std::integral_constant<index_t, I>) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    if constexpr (!is_simplified<repeat<TargetParser, I>>)
+      return simplify(repeat<TargetParser, I>{}).parse(InputString{});
+    else
+    {
+      return parse_count<TargetParser, I>(as_slice(InputString{}));
+    }
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(repeat<TargetParser, I>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    if constexpr (runs_as_dfa<repeat<TargetParser, I>>)
+      return match_dfa<repeat<TargetParser, I>>(state, position);
+    else
+    {
+      const index_t mark = state.mark();
+      for (index_t count = 0; count < I && position != no_match; ++count)
+        position = TargetParser{}.parse_at(state, position);
+      if (position == no_match)
+        state.rewind(mark);
+      return position;
+    }
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<repeat<TargetParser, I>>{}; }
+  constexpr auto operator~() const { return optional<repeat<TargetParser, I>>{}; }
+  constexpr auto operator++(int) const { return repeat_minimum<TargetParser, I>{}; }
+  constexpr auto operator--(int) const { return repeat_maximum<TargetParser, I>{}; }
+  template <index_t J>
+  constexpr auto operator[](::std::integral_constant<index_t, J>) const
+  {
+    return repeat_range<TargetParser, I, J>{};
+  }
+};
+
+template <char... Chars, index_t I>
+repeat(string<Chars...>, ::std::integral_constant<index_t, I>)->repeat<one_string<string<Chars...>>, I>;
+
+//////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////
 
 template <typename TargetParser, index_t I>
 struct repeat_minimum
@@ -417,18 +1855,35 @@ struct repeat_minimum
   constexpr repeat_minimum() {}
   constexpr repeat_minimum(TargetParser, ::std::integral_constant<index_t, I>) {}
 
-  template <index_t... Indices>
-  constexpr auto make_sequence(index_range<Indices...>) const
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    constexpr auto result = parse_count<TargetParser, I>(as_slice(InputString{}));
+    if constexpr (result.status())
+      return joined<decltype(result), decltype(zero_or_more<TargetParser>{}.parse(result.remainder()))>{};
+    else
+      return result;
+  }
+
+  constexpr auto parse(::std::string_view input) const
   {
-    constexpr auto new_targets =
-        typelist<decltype((Indices, TargetParser{}))...>{}.append(typelist<decltype(*TargetParser{})>{});
-    return new_targets.template apply<sequence>();
+    return runtime_parse(repeat_minimum<TargetParser, I>{}, input);
   }
 
-  template <index_t Count = 0, typename MatchedSoFar = string<>, typename InputString>
-  constexpr auto parse(InputString) const
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
   {
-    return make_sequence(make_index_range<0, I - 1>()).parse(InputString{});
+    if constexpr (::std::is_void_v<typename char_set_of<TargetParser>::type> &&
+                  runs_as_dfa<repeat_minimum<TargetParser, I>>)
+      return match_dfa<repeat_minimum<TargetParser, I>>(state, position);
+    else
+    {
+      const index_t end = repeat<TargetParser, I>{}.parse_at(state, position);
+      if (end == no_match)
+        return no_match;
+      else
+        return zero_or_more<TargetParser>{}.parse_at(state, end);
+    }
   }
 
   template <template <typename...> typename Output>
@@ -454,10 +1909,10 @@ struct repeat_maximum
   constexpr repeat_maximum() {}
   constexpr repeat_maximum(TargetParser, ::std::integral_constant<index_t, I>) {}
 
-  template <typename InputString>
+  template <typename InputString, typename = if_compile_time_string<InputString>>
   constexpr auto parse(InputString) const
   {
-    constexpr auto input_string = InputString{};
+    constexpr auto input_string = as_slice(InputString{});
     constexpr auto base = TargetParser{}.parse(input_string);
     constexpr auto result = zero_or_more<TargetParser>{}.parse(input_string);
     if constexpr (base.status())
@@ -465,10 +1920,32 @@ struct repeat_maximum
       if constexpr (result.match().size() <= (I * base.match().size()))
         return result;
       else
-        return parsed<decltype(result.match()), InputString, status::failure>{};
+        return parsed<decltype(result.match()), decltype(input_string), status::failure>{};
     }
     else
-      return parsed<string<>, InputString, status::success>{};
+      return parsed<decltype(take<0>(input_string)), decltype(input_string), status::success>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const
+  {
+    return runtime_parse(repeat_maximum<TargetParser, I>{}, input);
+  }
+
+  // mirrors the compile-time behaviour, every consecutive occurence is consumed and too many is a failure
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    const index_t mark = state.mark();
+    index_t count = 0;
+    index_t end = position;
+    for (index_t next = TargetParser{}.parse_at(state, end); next != no_match && next != end;
+         next = TargetParser{}.parse_at(state, end), ++count)
+      end = next;
+    if (count <= I)
+      return end;
+    state.rewind(mark);
+    state.committed = false;
+    return no_match;
   }
 
   template <template <typename...> typename Output>
@@ -494,10 +1971,10 @@ struct repeat_range
   constexpr repeat_range() {}
   constexpr repeat_range(TargetParser, ::std::integral_constant<index_t, Min>, ::std::integral_constant<index_t, Max>) {}
 
-  template <typename InputString>
+  template <typename InputString, typename = if_compile_time_string<InputString>>
   constexpr auto parse(InputString) const
   {
-    constexpr auto input_string = InputString{};
+    constexpr auto input_string = as_slice(InputString{});
     constexpr auto base = TargetParser{}.parse(input_string);
     constexpr auto result = zero_or_more<TargetParser>{}.parse(input_string);
     if constexpr (base.status())
@@ -506,10 +1983,32 @@ struct repeat_range
                     result.match().size() <= (Max * base.match().size()))
         return result;
       else
-        return parsed<decltype(result.match()), InputString, status::failure>{};
+        return parsed<decltype(result.match()), decltype(input_string), status::failure>{};
     }
     else
-      return parsed<string<>, InputString, status::success>{};
+      return parsed<decltype(take<0>(input_string)), decltype(input_string), status::success>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const
+  {
+    return runtime_parse(repeat_range<TargetParser, Min, Max>{}, input);
+  }
+
+  // mirrors the compile-time behaviour, no occurence at all is a success
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    const index_t mark = state.mark();
+    index_t count = 0;
+    index_t end = position;
+    for (index_t next = TargetParser{}.parse_at(state, end); next != no_match && next != end;
+         next = TargetParser{}.parse_at(state, end), ++count)
+      end = next;
+    if (count == 0 || (count >= Min && count <= Max))
+      return end;
+    state.rewind(mark);
+    state.committed = false;
+    return no_match;
   }
 
   template <template <typename...> typename Output>
@@ -535,21 +2034,32 @@ struct sequence
   constexpr sequence() {}
   constexpr sequence(InitTargetParser, TargetParsers...) {}
 
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    return parse_parts(InputString{});
+  }
+
   template <typename InputString,
             index_t End = sizeof...(TargetParsers),
             index_t CurrentIndex = 0,
             typename CurrentTargetParser = InitTargetParser,
             typename... NextTargetParsers>
-  constexpr auto parse(InputString) const
+  constexpr auto parse_parts(InputString) const
   {
-    if constexpr (CurrentIndex == 0)
+    if constexpr (CurrentIndex == 0 && !is_simplified<sequence<InitTargetParser, TargetParsers...>>)
+      return simplify(sequence<InitTargetParser, TargetParsers...>{}).parse(InputString{});
+    else if constexpr (CurrentIndex == 0)
     {
       constexpr InputString input_string;
       constexpr CurrentTargetParser target_parser;
       constexpr auto result = target_parser.parse(input_string);
       if constexpr (result.status())
-        return result +
-               parse<decltype(result.remainder()), End, CurrentIndex + 1, TargetParsers...>(result.remainder());
+        return typename after_part<
+            CurrentTargetParser,
+            joined<decltype(result),
+                   decltype(parse_parts<decltype(result.remainder()), End, CurrentIndex + 1, TargetParsers...>(
+                       result.remainder()))>>::type{};
       else
         return result;
     }
@@ -559,99 +2069,536 @@ struct sequence
       constexpr CurrentTargetParser target_parser;
       constexpr auto result = target_parser.parse(input_string);
       if constexpr (result.status())
-        return result +
-               parse<decltype(result.remainder()), End, CurrentIndex + 1, NextTargetParsers...>(result.remainder());
+        return typename after_part<
+            CurrentTargetParser,
+            joined<decltype(result),
+                   decltype(parse_parts<decltype(result.remainder()), End, CurrentIndex + 1, NextTargetParsers...>(
+                       result.remainder()))>>::type{};
+      else
+        return result;
+    }
+    else
+    {
+      constexpr InputString input_string;
+      constexpr CurrentTargetParser target_parser;
+      constexpr auto result = target_parser.parse(input_string);
+      return result;
+    }
+  }
+
+  constexpr auto parse(::std::string_view input) const
+  {
+    return runtime_parse(sequence<InitTargetParser, TargetParsers...>{}, input);
+  }
+
+  // a failing part reports whether it was committed, parts after this sequence's own commit always are
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    if constexpr (runs_as_dfa<sequence<InitTargetParser, TargetParsers...>>)
+      return match_dfa<sequence<InitTargetParser, TargetParsers...>>(state, position);
+    else
+    {
+      const index_t mark = state.mark();
+      bool past_commit = false;
+      (((state.committed = false, (position = InitTargetParser{}.parse_at(state, position)) != no_match) &&
+        ((past_commit = past_commit || ::std::is_same_v<InitTargetParser, commit>), true)) &&
+       ... &&
+       ((state.committed = false, (position = TargetParsers{}.parse_at(state, position)) != no_match) &&
+        ((past_commit = past_commit || ::std::is_same_v<TargetParsers, commit>), true)));
+      if (position == no_match)
+      {
+        state.rewind(mark);
+        state.committed = state.committed || past_commit;
+      }
+      return position;
+    }
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<sequence<InitTargetParser, TargetParsers...>>{}; }
+  constexpr auto operator~() const { return optional<sequence<InitTargetParser, TargetParsers...>>{}; }
+  constexpr auto operator+() const { return one_or_more<sequence<InitTargetParser, TargetParsers...>>{}; }
+  constexpr auto operator*() const { return zero_or_more<sequence<InitTargetParser, TargetParsers...>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<sequence<InitTargetParser, TargetParsers...>, I>{};
+  }
+};
+
+template <typename InitTargetParser, typename... TargetParsers>
+struct one_of
+{
+  using parser_tag = tag_t;
+  constexpr one_of() {}
+  constexpr one_of(InitTargetParser, TargetParsers...) {}
+
+  // alternatives that cannot start with the lookahead character are skipped without being instantiated,
+  // only the ones whose first sets overlap are tried in order
+  template <typename InputString, typename CurrentTargetParser, typename... NextTargetParsers>
+  constexpr auto parse_impl() const
+  {
+    if constexpr (!first_set_of<CurrentTargetParser>.admits(InputString{}.view()))
+    {
+      if constexpr (sizeof...(NextTargetParsers) == 0)
+        return parsed<decltype(take<0>(InputString{})), InputString, status::failure>{};
       else
+        return parse_impl<InputString, NextTargetParsers...>();
+    }
+    else
+    {
+      constexpr auto result = CurrentTargetParser{}.parse(InputString{});
+      if constexpr (result.status())
         return result;
+      else if constexpr (result.committed() || sizeof...(NextTargetParsers) == 0)
+        return parsed<decltype(result.match()), InputString, status::failure>{};
+      else
+        return parse_impl<InputString, NextTargetParsers...>();
+    }
+  }
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    if constexpr (!is_simplified<one_of<InitTargetParser, TargetParsers...>>)
+      return simplify(one_of<InitTargetParser, TargetParsers...>{}).parse(InputString{});
+    else
+    {
+      using input_slice = decltype(as_slice(InputString{}));
+      return decltype(*this){}.template parse_impl<input_slice, InitTargetParser, TargetParsers...>();
+    }
+  }
+
+  constexpr auto parse(::std::string_view input) const
+  {
+    return runtime_parse(one_of<InitTargetParser, TargetParsers...>{}, input);
+  }
+
+  // alternatives past the 64 a mask holds are always tried
+  static constexpr bool viable_at(::std::uint64_t viable, index_t alternative)
+  {
+    return alternative >= 64 || ((viable >> alternative) & 1);
+  }
+
+  template <typename State, typename... Alternatives>
+  static constexpr index_t parse_viable(State &state, index_t position, ::std::uint64_t viable)
+  {
+    index_t end = no_match;
+    index_t alternative = 0;
+    ((viable_at(viable, alternative++) &&
+      (state.committed = false, (end = Alternatives{}.parse_at(state, position)) != no_match || state.committed)) ||
+     ...);
+    state.committed = false;
+    return end;
+  }
+
+  // the lookahead character indexes a table of the alternatives that may match, so the others are never run
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    if constexpr (runs_as_dfa<one_of<InitTargetParser, TargetParsers...>>)
+      return match_dfa<one_of<InitTargetParser, TargetParsers...>>(state, position);
+    else if constexpr (sizeof...(TargetParsers) < 64)
+    {
+      constexpr const prediction_table &table = prediction_table_of<InitTargetParser, TargetParsers...>;
+      state.examine(position + 1);
+      const ::std::uint64_t viable = position < state.size()
+                                         ? table.viable[static_cast<unsigned char>(state.data[position])]
+                                         : table.at_end;
+      return parse_viable<State, InitTargetParser, TargetParsers...>(state, position, viable);
     }
+    else
+      return parse_viable<State, InitTargetParser, TargetParsers...>(state, position, ~::std::uint64_t(0));
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<one_of<InitTargetParser, TargetParsers...>>{}; }
+  constexpr auto operator~() const { return optional<one_of<InitTargetParser, TargetParsers...>>{}; }
+  constexpr auto operator+() const { return one_or_more<one_of<InitTargetParser, TargetParsers...>>{}; }
+  constexpr auto operator*() const { return zero_or_more<one_of<InitTargetParser, TargetParsers...>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<one_of<InitTargetParser, TargetParsers...>, I>{};
+  }
+};
+
+template <typename CharSet>
+struct char_class
+{
+  using parser_tag = tag_t;
+  constexpr char_class() {}
+  template <char... Chars>
+  constexpr char_class(string<Chars...>)
+  {
+  }
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    constexpr auto input_string = as_slice(InputString{});
+    if constexpr (input_string.size() == 0)
+      return parsed<decltype(input_string), decltype(input_string), status::failure>{};
+    else if constexpr (table_of<CharSet>.contains(input_string.front()))
+      return parsed<decltype(take<1>(input_string)), decltype(drop<1>(input_string)), status::success>{};
+    else
+      return parsed<decltype(take<0>(input_string)), decltype(input_string), status::failure>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(char_class<CharSet>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    state.examine(position + 1);
+    if (position < state.size() && table_of<CharSet>.contains(state.data[position]))
+      return position + 1;
+    else
+      return no_match;
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  // the complement matches one character like filter<...> would, but with a single lookup
+  constexpr auto operator!() const { return char_class<chars_complement<CharSet>>{}; }
+  constexpr auto operator~() const { return optional<char_class<CharSet>>{}; }
+  constexpr auto operator+() const { return one_or_more<char_class<CharSet>>{}; }
+  constexpr auto operator*() const { return zero_or_more<char_class<CharSet>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<char_class<CharSet>, I>{};
+  }
+};
+
+template <char... Chars>
+char_class(string<Chars...>)->char_class<chars_of<string<Chars...>>>;
+
+// a char_class<...> matching any character from { First } to { Last }, both included
+template <char First, char Last>
+constexpr auto
+range(::std::integral_constant<char, First>, ::std::integral_constant<char, Last>)
+{
+  return char_class<chars_between<First, Last>>{};
+}
+
+// a char_class<...> matching the characters both { L } and { R } match
+template <typename L, typename R>
+constexpr auto
+intersect(char_class<L>, char_class<R>)
+{
+  return char_class<chars_intersection<L, R>>{};
+}
+
+template <typename L, typename R>
+constexpr auto
+intersect(one_char<L>, R)
+{
+  return intersect(char_class<chars_of<L>>{}, R{});
+}
+
+template <typename L, typename R>
+constexpr auto
+intersect(char_class<L>, one_char<R>)
+{
+  return intersect(char_class<L>{}, char_class<chars_of<R>>{});
+}
+
+//////////////////////////////////////////////////////////////
+
+struct anything
+{
+  using parser_tag = tag_t;
+  constexpr anything() {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    constexpr auto input_string = as_slice(InputString{});
+    static_assert(input_string.size() > 0, "cxl::string<...> not big enough to hold anything");
+    return parsed<decltype(take<1>(input_string)), decltype(drop<1>(input_string)), status::success>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(anything{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    state.examine(position + 1);
+    return position < state.size() ? position + 1 : no_match;
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator~() const { return optional<anything>{}; }
+  constexpr auto operator+() const { return one_or_more<anything>{}; }
+  constexpr auto operator*() const { return zero_or_more<anything>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<anything, I>{};
+  }
+};
+
+struct commit
+{
+  using parser_tag = tag_t;
+  constexpr commit() {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    constexpr auto input_string = as_slice(InputString{});
+    return parsed<decltype(take<0>(input_string)), decltype(input_string), status::success>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(commit{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &, index_t position) const
+  {
+    return position;
+  }
+};
+
+inline namespace detail
+{
+constexpr first_set
+first_of(commit)
+{
+  first_set result;
+  result.empty = true;
+  return result;
+}
+
+constexpr first_set
+first_of(anything)
+{
+  return first_set{chars_complement<chars_of<string<>>>::table(), false};
+}
+
+constexpr bool
+regular_before(anything, const char_table &)
+{
+  return true;
+}
+
+constexpr index_t
+add_nfa(anything, nfa &automaton, index_t from)
+{
+  return automaton.add_chars(from, chars_complement<chars_of<string<>>>::table());
+}
+} // namespace detail
+
+//////////////////////////////////////////////////////////////
+
+template <typename TargetParser, template <typename...> typename Output>
+struct generator
+{
+  using parser_tag = tag_t;
+  constexpr generator() {}
+  constexpr generator(TargetParser, Output<>) {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    if constexpr (!is_simplified<generator<TargetParser, Output>>)
+      return simplify(generator<TargetParser, Output>{}).parse(InputString{});
     else
     {
-      constexpr InputString input_string;
-      constexpr CurrentTargetParser target_parser;
+      constexpr auto target_parser = TargetParser{};
+      constexpr auto input_string = InputString{};
       constexpr auto result = target_parser.parse(input_string);
-      return result;
+      if constexpr (result.tree().size() == 0)
+        return result.generate(Output<decltype(materialize(result.match()))>{});
+      else
+        return result.generate(apply_output<Output>(result.tree()));
     }
   }
 
-  template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
+  constexpr auto parse(::std::string_view input) const
   {
-    return generator(decltype(*this){}, Output<>{});
+    return runtime_parse(generator<TargetParser, Output>{}, input);
   }
 
-  constexpr auto operator!() const { return filter<sequence<InitTargetParser, TargetParsers...>>{}; }
-  constexpr auto operator~() const { return optional<sequence<InitTargetParser, TargetParsers...>>{}; }
-  constexpr auto operator+() const { return one_or_more<sequence<InitTargetParser, TargetParsers...>>{}; }
-  constexpr auto operator*() const { return zero_or_more<sequence<InitTargetParser, TargetParsers...>>{}; }
+  // output types only exist at compile-time, at runtime a generator matches exactly like its target
+  // and records where that match is when the parse is capturing
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    const index_t slot = state.begin_capture();
+    const index_t end = TargetParser{}.parse_at(state, position);
+    if (end == no_match)
+      state.rewind(slot);
+    else
+      state.template end_capture<Output>(slot, position, end - position);
+    return end;
+  }
+
+  constexpr auto disable() const { return TargetParser{}; }
+
+  constexpr auto operator!() const { return filter<generator<TargetParser, Output>>{}; }
+  constexpr auto operator~() const { return optional<generator<TargetParser, Output>>{}; }
+  constexpr auto operator+() const { return one_or_more<generator<TargetParser, Output>>{}; }
+  constexpr auto operator*() const { return zero_or_more<generator<TargetParser, Output>>{}; }
 
   template <index_t I>
   constexpr auto operator[](::std::integral_constant<index_t, I>) const
   {
-    return repeat<sequence<InitTargetParser, TargetParsers...>, I>{};
+    return repeat<generator<TargetParser, Output>, I>{};
   }
 };
 
-template <typename InitTargetParser, typename... TargetParsers>
-struct one_of
+//////////////////////////////////////////////////////////////
+
+template <typename OperatorParser, index_t Precedence, associativity Associativity, template <typename...> typename Output>
+struct binary_operator
+{
+  using parser_type = OperatorParser;
+  template <typename... Children>
+  using output = Output<Children...>;
+  static constexpr index_t precedence = Precedence;
+  static constexpr bool right_associative = Associativity == associativity::right;
+
+  constexpr binary_operator() {}
+  constexpr binary_operator(OperatorParser,
+                            ::std::integral_constant<index_t, Precedence>,
+                            ::std::integral_constant<associativity, Associativity>,
+                            Output<>)
+  {
+  }
+};
+
+template <typename OperandParser, typename... Operators>
+struct operator_table
 {
+  static_assert(sizeof...(Operators) > 0, "operator_table<...> needs at least one binary_operator<...>");
+
   using parser_tag = tag_t;
-  constexpr one_of() {}
-  constexpr one_of(InitTargetParser, TargetParsers...) {}
+  constexpr operator_table() {}
+  constexpr operator_table(OperandParser, Operators...) {}
 
-  template <typename InputString, typename CurrentTargetParser, typename... NextTargetParsers>
-  constexpr auto parse_impl() const
+  // the first operator, in table order, binding at least as tightly as { MinPrecedence } and matching here
+  template <index_t MinPrecedence, typename InputString>
+  static constexpr index_t find_operator(InputString)
   {
-    constexpr auto result = CurrentTargetParser{}.parse(InputString{});
-    if constexpr (result.status())
-      return result;
-    else if constexpr (sizeof...(NextTargetParsers) == 0)
+    constexpr bool matches[] = {(Operators::precedence >= MinPrecedence &&
+                                 typename Operators::parser_type{}.parse(InputString{}).status())...};
+    for (index_t i = 0; i < index_t(sizeof...(Operators)); ++i)
+      if (matches[i])
+        return i;
+    return no_match;
+  }
+
+  template <template <typename...> typename Output, typename Lhs, typename Operator, typename Rhs>
+  static constexpr auto bind(Lhs, Operator, Rhs)
+  {
+    constexpr auto combined = joined<joined<Lhs, Operator>, Rhs>{};
+    using match = decltype(combined.match());
+    using remainder = decltype(combined.remainder());
+    if constexpr (combined.tree().size() == 0)
+      return parsed<match, remainder, status::success, typelist<Output<decltype(materialize(match{}))>>>{};
+    else
+      return parsed<match, remainder, status::success, typelist<decltype(apply_output<Output>(combined.tree()))>>{};
+  }
+
+  template <index_t MinPrecedence, typename InputString>
+  static constexpr auto parse_expression(InputString)
+  {
+    constexpr auto operand = OperandParser{}.parse(InputString{});
+    if constexpr (operand.status())
+      return parse_operators<MinPrecedence>(operand);
+    else
+      return operand;
+  }
+
+  // an operator without a right operand is left unconsumed, like any other failed optional tail
+  template <index_t MinPrecedence, typename Lhs>
+  static constexpr auto parse_operators(Lhs)
+  {
+    constexpr auto input_string = Lhs{}.remainder();
+    constexpr index_t index = find_operator<MinPrecedence>(input_string);
+    if constexpr (index == no_match)
+      return Lhs{};
+    else
     {
-      if constexpr (result.status())
-        return result;
+      using entry = select_t<index, Operators...>;
+      constexpr auto op = typename entry::parser_type{}.parse(input_string);
+      constexpr auto rhs =
+          parse_expression<entry::right_associative ? entry::precedence : entry::precedence + 1>(op.remainder());
+      if constexpr (rhs.status())
+        return parse_operators<MinPrecedence>(bind<entry::template output>(Lhs{}, op, rhs));
       else
-        return parsed<decltype(result.match()), InputString, status::failure>{};
+        return Lhs{};
     }
-    else
-      return parse_impl<InputString, NextTargetParsers...>();
   }
 
-  template <typename InputString>
+  template <typename InputString, typename = if_compile_time_string<InputString>>
   constexpr auto parse(InputString) const
   {
-    return decltype(*this){}.template parse_impl<InputString, InitTargetParser, TargetParsers...>();
+    constexpr index_t lowest = ::std::min({Operators::precedence...});
+    return parse_expression<lowest>(as_slice(InputString{}));
   }
 
-  template <template <typename...> typename Output>
-  constexpr auto generate(Output<>) const
+  constexpr auto parse(::std::string_view input) const
   {
-    return generator(decltype(*this){}, Output<>{});
+    return runtime_parse(operator_table<OperandParser, Operators...>{}, input);
   }
 
-  constexpr auto operator!() const { return filter<one_of<InitTargetParser, TargetParsers...>>{}; }
-  constexpr auto operator~() const { return optional<one_of<InitTargetParser, TargetParsers...>>{}; }
-  constexpr auto operator+() const { return one_or_more<one_of<InitTargetParser, TargetParsers...>>{}; }
-  constexpr auto operator*() const { return zero_or_more<one_of<InitTargetParser, TargetParsers...>>{}; }
-
-  template <index_t I>
-  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  template <typename State>
+  static constexpr index_t parse_expression_at(State &state, index_t position, index_t min_precedence)
   {
-    return repeat<one_of<InitTargetParser, TargetParsers...>, I>{};
+    index_t end = OperandParser{}.parse_at(state, position);
+    while (end != no_match)
+    {
+      const index_t mark = state.mark();
+      index_t operator_end = no_match;
+      index_t precedence = 0;
+      bool right = false;
+      ((Operators::precedence >= min_precedence &&
+        (operator_end = typename Operators::parser_type{}.parse_at(state, end)) != no_match &&
+        ((precedence = Operators::precedence), (right = Operators::right_associative), true)) ||
+       ...);
+      if (operator_end == no_match)
+        break;
+      const index_t rhs_end = parse_expression_at(state, operator_end, right ? precedence : precedence + 1);
+      if (rhs_end == no_match)
+      {
+        state.rewind(mark);
+        break;
+      }
+      end = rhs_end;
+    }
+    return end;
   }
-};
-
-struct anything
-{
-  using parser_tag = tag_t;
-  constexpr anything() {}
 
-  template <typename InputString>
-  constexpr auto parse(InputString) const
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
   {
-    constexpr auto input_string = InputString{};
-    static_assert(input_string.size() > 0, "cxl::string<...> not big enough to hold anything");
-    return parsed<string<input_string[0]>,
-                  decltype(substr(++input_string.begin(), input_string.end())),
-                  status::success>{};
+    return parse_expression_at(state, position, ::std::min({Operators::precedence...}));
   }
 
   template <template <typename...> typename Output>
@@ -660,49 +2607,64 @@ struct anything
     return generator(decltype(*this){}, Output<>{});
   }
 
-  constexpr auto operator~() const { return optional<anything>{}; }
-  constexpr auto operator+() const { return one_or_more<anything>{}; }
-  constexpr auto operator*() const { return zero_or_more<anything>{}; }
-
-  template <index_t I>
-  constexpr auto operator[](::std::integral_constant<index_t, I>) const
-  {
-    return repeat<anything, I>{};
-  }
+  constexpr auto operator!() const { return filter<operator_table<OperandParser, Operators...>>{}; }
+  constexpr auto operator~() const { return optional<operator_table<OperandParser, Operators...>>{}; }
+  constexpr auto operator+() const { return one_or_more<operator_table<OperandParser, Operators...>>{}; }
+  constexpr auto operator*() const { return zero_or_more<operator_table<OperandParser, Operators...>>{}; }
 };
 
 //////////////////////////////////////////////////////////////
 
-template <typename TargetParser, template <typename...> typename Output>
-struct generator
+// a rule<...> is an ordinary type, so its parse is instantiated once per input slice, that is once per
+// position in the input, however many times the grammar reaches it there
+template <typename Tag>
+struct rule
 {
   using parser_tag = tag_t;
-  constexpr generator() {}
-  constexpr generator(TargetParser, Output<>) {}
+  constexpr rule() {}
 
-  template <typename InputString>
+  template <typename InputString, typename = if_compile_time_string<InputString>>
   constexpr auto parse(InputString) const
   {
-    constexpr auto target_parser = TargetParser{};
-    constexpr auto input_string = InputString{};
-    constexpr auto result = target_parser.parse(input_string);
-    if constexpr (result.tree().size() == 0)
-      return result.generate(Output<decltype(result.match())>{});
+    return Tag::definition().parse(as_slice(InputString{}));
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(rule<Tag>{}, input); }
+
+  // a memoized parse runs the definition once per position, the result is remembered along with whether the
+  // failure was committed
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    if constexpr (State::template memo_index<rule<Tag>> < 0)
+      return Tag::definition().parse_at(state, position);
     else
-      return result.generate(result.tree().template apply<Output>());
+    {
+      index_t end = no_match;
+      if (state.template recall<rule<Tag>>(position, end))
+        return end;
+      const index_t saved = state.begin_rule(position);
+      end = Tag::definition().parse_at(state, position);
+      state.template remember<rule<Tag>>(position, end, saved);
+      return end;
+    }
   }
 
-  constexpr auto disable() const { return TargetParser{}; }
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
 
-  constexpr auto operator!() const { return filter<generator<TargetParser, Output>>{}; }
-  constexpr auto operator~() const { return optional<generator<TargetParser, Output>>{}; }
-  constexpr auto operator+() const { return one_or_more<generator<TargetParser, Output>>{}; }
-  constexpr auto operator*() const { return zero_or_more<generator<TargetParser, Output>>{}; }
+  constexpr auto operator!() const { return filter<rule<Tag>>{}; }
+  constexpr auto operator~() const { return optional<rule<Tag>>{}; }
+  constexpr auto operator+() const { return one_or_more<rule<Tag>>{}; }
+  constexpr auto operator*() const { return zero_or_more<rule<Tag>>{}; }
 
   template <index_t I>
   constexpr auto operator[](::std::integral_constant<index_t, I>) const
   {
-    return repeat<generator<TargetParser, Output>, I>{};
+    return repeat<rule<Tag>, I>{};
   }
 };
 
@@ -751,4 +2713,276 @@ operator|(L, one_of<R...>)
 {
   return one_of<L, R...>{};
 }
+
+// alternatives of single characters merge into one char_class<...>
+template <typename L, typename R>
+constexpr auto
+operator|(char_class<L>, char_class<R>)
+{
+  return char_class<chars_union<L, R>>{};
+}
+template <typename L, typename R>
+constexpr auto
+operator|(one_char<L>, char_class<R>)
+{
+  return char_class<chars_union<chars_of<L>, R>>{};
+}
+template <typename L, typename R>
+constexpr auto
+operator|(char_class<L>, one_char<R>)
+{
+  return char_class<chars_union<L, chars_of<R>>>{};
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+
+// simplify(...) rewrites a parser into an equivalent one that is cheaper to instantiate and to run: nested
+// sequences and alternatives are flattened, redundant repetition wrappers removed, adjacent literals merged
+// into one one_string<...> and adjacent single character alternatives fused into one char_class<...>
+inline namespace detail
+{
+template <template <typename> typename Wrapper, typename Parser>
+struct wrapped : ::std::false_type
+{
+};
+
+template <template <typename> typename Wrapper, typename TargetParser>
+struct wrapped<Wrapper, Wrapper<TargetParser>> : ::std::true_type
+{
+  using target = TargetParser;
+};
+
+// whether a commit is among the parsers { Parser } is made of
+template <typename Parser>
+struct contains_commit : ::std::is_same<Parser, commit>
+{
+};
+
+template <template <typename...> typename Parser, typename... TargetParsers>
+struct contains_commit<Parser<TargetParsers...>> : ::std::disjunction<contains_commit<TargetParsers>...>
+{
+};
+
+// a nested combinator is flattened into the enclosing one of the same kind, unless it holds a commit, whose effect
+// ends with the sequence it is in, flattening it would extend the commit over the parts that follow
+template <template <typename...> typename Combinator, typename Parser>
+struct combines : ::std::false_type
+{
+};
+
+template <template <typename...> typename Combinator, typename... TargetParsers>
+struct combines<Combinator, Combinator<TargetParsers...>>
+    : ::std::negation<::std::disjunction<contains_commit<TargetParsers>...>>
+{
+};
+
+// the characters a parser matches when it is a literal, void otherwise
+template <typename Parser>
+struct literal_of
+{
+  using type = void;
+};
+
+template <char C, char... Chars>
+struct literal_of<one_string<string<C, Chars...>>>
+{
+  using type = string<C, Chars...>;
+};
+
+template <char C>
+struct literal_of<one_char<string<C>>>
+{
+  using type = string<C>;
+};
+
+// two adjacent parts of a sequence<...> or a one_of<...> as one parser, void when they cannot be merged
+template <template <typename...> typename Combinator, typename Last, typename Part>
+constexpr auto
+merge_parts(Last, Part)
+{
+  if constexpr (::std::is_same_v<Combinator<Last, Part>, sequence<Last, Part>>)
+  {
+    using last_literal = typename literal_of<Last>::type;
+    using part_literal = typename literal_of<Part>::type;
+    if constexpr (!::std::is_void_v<last_literal> && !::std::is_void_v<part_literal>)
+      return one_string<decltype(last_literal{} + part_literal{})>{};
+  }
+  else
+  {
+    using last_set = typename char_set_of<Last>::type;
+    using part_set = typename char_set_of<Part>::type;
+    if constexpr (!::std::is_void_v<last_set> && !::std::is_void_v<part_set>)
+      return char_class<chars_union<last_set, part_set>>{};
+  }
+}
+
+// the parts simplified so far, { Last } is kept apart so it can still be merged with the next part
+template <template <typename...> typename Combinator, typename Done, typename Last>
+struct parts
+{
+};
+
+template <template <typename...> typename Combinator, typename Parts>
+constexpr auto
+append_parts(Parts)
+{
+  return Parts{};
+}
+
+template <template <typename...> typename Combinator, typename Parts, typename Part, typename... NextParts>
+constexpr auto
+append_parts(Parts, Part, NextParts...);
+
+template <template <typename...> typename Combinator, typename Parts, typename... NestedParts>
+constexpr auto
+append_nested(Parts, Combinator<NestedParts...>)
+{
+  return append_parts<Combinator>(Parts{}, NestedParts{}...);
+}
+
+template <template <typename...> typename Combinator, typename... Done, typename Last, typename Part>
+constexpr auto
+append_part(parts<Combinator, typelist<Done...>, Last>, Part)
+{
+  using current = parts<Combinator, typelist<Done...>, Last>;
+  if constexpr (combines<Combinator, Part>::value)
+    return append_nested<Combinator>(current{}, Part{});
+  else if constexpr (::std::is_void_v<Last>)
+    return parts<Combinator, typelist<Done...>, Part>{};
+  else if constexpr (!::std::is_void_v<decltype(merge_parts<Combinator>(Last{}, Part{}))>)
+    return parts<Combinator, typelist<Done...>, decltype(merge_parts<Combinator>(Last{}, Part{}))>{};
+  else
+    return parts<Combinator, typelist<Done..., Last>, Part>{};
+}
+
+template <template <typename...> typename Combinator, typename Parts, typename Part, typename... NextParts>
+constexpr auto
+append_parts(Parts, Part, NextParts...)
+{
+  return append_parts<Combinator>(append_part(Parts{}, Part{}), NextParts{}...);
+}
+
+template <template <typename...> typename Combinator, typename... Done, typename Last>
+constexpr auto
+finish_parts(parts<Combinator, typelist<Done...>, Last>)
+{
+  if constexpr (sizeof...(Done) == 0)
+    return Last{};
+  else
+    return Combinator<Done..., Last>{};
+}
+} // namespace detail
+
+template <typename TargetParser>
+constexpr auto
+simplify(before<TargetParser>)
+{
+  return before<decltype(simplify(TargetParser{}))>{};
+}
+
+// filtering a single character parser is matching the complement of its set
+template <typename TargetParser>
+constexpr auto
+simplify(filter<TargetParser>)
+{
+  using target = decltype(simplify(TargetParser{}));
+  using char_set = typename char_set_of<target>::type;
+  if constexpr (!::std::is_void_v<char_set>)
+    return char_class<chars_complement<char_set>>{};
+  else
+    return filter<target>{};
+}
+
+template <typename TargetParser>
+constexpr auto
+simplify(optional<TargetParser>)
+{
+  using target = decltype(simplify(TargetParser{}));
+  if constexpr (wrapped<optional, target>::value || wrapped<zero_or_more, target>::value)
+    return target{};
+  else
+    return optional<target>{};
+}
+
+template <typename TargetParser>
+constexpr auto
+simplify(zero_or_more<TargetParser>)
+{
+  using target = decltype(simplify(TargetParser{}));
+  if constexpr (wrapped<optional, target>::value)
+    return zero_or_more<typename wrapped<optional, target>::target>{};
+  else if constexpr (wrapped<one_or_more, target>::value)
+    return zero_or_more<typename wrapped<one_or_more, target>::target>{};
+  else if constexpr (wrapped<zero_or_more, target>::value)
+    return target{};
+  else
+    return zero_or_more<target>{};
+}
+
+template <typename TargetParser>
+constexpr auto
+simplify(one_or_more<TargetParser>)
+{
+  using target = decltype(simplify(TargetParser{}));
+  if constexpr (wrapped<optional, target>::value)
+    return zero_or_more<typename wrapped<optional, target>::target>{};
+  else if constexpr (wrapped<zero_or_more, target>::value || wrapped<one_or_more, target>::value)
+    return target{};
+  else
+    return one_or_more<target>{};
+}
+
+template <typename TargetParser, index_t I>
+constexpr auto
+simplify(repeat<TargetParser, I>)
+{
+  if constexpr (I == 1)
+    return simplify(TargetParser{});
+  else
+    return repeat<decltype(simplify(TargetParser{})), I>{};
+}
+
+template <typename TargetParser, index_t I>
+constexpr auto
+simplify(repeat_minimum<TargetParser, I>)
+{
+  return repeat_minimum<decltype(simplify(TargetParser{})), I>{};
+}
+
+template <typename TargetParser, index_t I>
+constexpr auto
+simplify(repeat_maximum<TargetParser, I>)
+{
+  return repeat_maximum<decltype(simplify(TargetParser{})), I>{};
+}
+
+template <typename TargetParser, index_t Min, index_t Max>
+constexpr auto
+simplify(repeat_range<TargetParser, Min, Max>)
+{
+  return repeat_range<decltype(simplify(TargetParser{})), Min, Max>{};
+}
+
+template <typename... TargetParsers>
+constexpr auto
+simplify(sequence<TargetParsers...>)
+{
+  return finish_parts(
+      append_parts<sequence>(parts<sequence, typelist<>, void>{}, decltype(simplify(TargetParsers{})){}...));
+}
+
+template <typename... TargetParsers>
+constexpr auto
+simplify(one_of<TargetParsers...>)
+{
+  return finish_parts(
+      append_parts<one_of>(parts<one_of, typelist<>, void>{}, decltype(simplify(TargetParsers{})){}...));
+}
+
+template <typename TargetParser, template <typename...> typename Output>
+constexpr auto
+simplify(generator<TargetParser, Output>)
+{
+  return generator<decltype(simplify(TargetParser{})), Output>{};
+}
 } // namespace cxl::parse
\ No newline at end of file
@@ -0,0 +1,558 @@
+#pragma once
+
+#include "parsers.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+
+#include <string_view>
+
+namespace cxl::parse
+{
+
+inline namespace detail
+{
+// the characters an escape stands for, escaped characters without a meaning of their own stand for themselves
+template <char C>
+struct regex_escape
+{
+  using type = chars_of<string<C>>;
+};
+
+template <>
+struct regex_escape<'d'>
+{
+  using type = chars_between<'0', '9'>;
+};
+
+template <>
+struct regex_escape<'w'>
+{
+  using type = chars_union<chars_union<chars_between<'a', 'z'>, chars_between<'A', 'Z'>>,
+                           chars_union<chars_between<'0', '9'>, chars_of<string<'_'>>>>;
+};
+
+template <>
+struct regex_escape<'s'>
+{
+  using type = chars_of<string<' ', '\t', '\n', '\r', '\f', '\v'>>;
+};
+
+template <>
+struct regex_escape<'D'>
+{
+  using type = chars_complement<typename regex_escape<'d'>::type>;
+};
+
+template <>
+struct regex_escape<'W'>
+{
+  using type = chars_complement<typename regex_escape<'w'>::type>;
+};
+
+template <>
+struct regex_escape<'S'>
+{
+  using type = chars_complement<typename regex_escape<'s'>::type>;
+};
+
+template <>
+struct regex_escape<'n'>
+{
+  using type = chars_of<string<'\n'>>;
+};
+
+template <>
+struct regex_escape<'r'>
+{
+  using type = chars_of<string<'\r'>>;
+};
+
+template <>
+struct regex_escape<'t'>
+{
+  using type = chars_of<string<'\t'>>;
+};
+
+template <>
+struct regex_escape<'f'>
+{
+  using type = chars_of<string<'\f'>>;
+};
+
+template <>
+struct regex_escape<'v'>
+{
+  using type = chars_of<string<'\v'>>;
+};
+
+// the nodes the regex grammar generates, a failed attempt may generate nodes from partial matches too, so they
+// are plain tags and only the tree of a successful parse is read, through regex_set_of<...> and regex_syntax<...>
+template <typename... Match>
+struct regex_char
+{
+};
+
+template <typename... Match>
+struct regex_range
+{
+};
+
+template <typename... Items>
+struct regex_class
+{
+};
+
+template <typename... Items>
+struct regex_negated_class
+{
+};
+
+template <typename... Match>
+struct regex_any
+{
+};
+
+template <typename... Match>
+struct regex_quantifier
+{
+};
+
+template <typename... Children>
+struct regex_piece
+{
+};
+
+template <typename... Pieces>
+struct regex_concat
+{
+};
+
+template <typename... Branches>
+struct regex_alternation
+{
+};
+
+// a generated node lists every node generated while its target matched, in the order they were generated, the
+// nodes of single characters and quantifiers list none
+template <typename Node>
+struct regex_descendants : ::std::integral_constant<index_t, 0>
+{
+};
+
+template <typename... Items>
+struct regex_descendants<regex_class<Items...>> : ::std::integral_constant<index_t, sizeof...(Items)>
+{
+};
+
+template <typename... Items>
+struct regex_descendants<regex_negated_class<Items...>> : ::std::integral_constant<index_t, sizeof...(Items)>
+{
+};
+
+template <typename... Children>
+struct regex_descendants<regex_piece<Children...>> : ::std::integral_constant<index_t, sizeof...(Children)>
+{
+};
+
+template <typename... Pieces>
+struct regex_descendants<regex_concat<Pieces...>> : ::std::integral_constant<index_t, sizeof...(Pieces)>
+{
+};
+
+template <typename... Branches>
+struct regex_descendants<regex_alternation<Branches...>> : ::std::integral_constant<index_t, sizeof...(Branches)>
+{
+};
+
+// the direct children among { Nodes }, the last node is one and every other one precedes the descendants of
+// the child after it
+template <typename... Nodes>
+struct regex_children
+{
+  static constexpr index_t size = sizeof...(Nodes);
+  static constexpr index_t descendants[] = {regex_descendants<Nodes>::value..., 0};
+
+  static constexpr index_t count = [] {
+    index_t result = 0;
+    for (index_t i = size - 1; i >= 0; i -= descendants[i] + 1)
+      ++result;
+    return result;
+  }();
+
+  static constexpr ::std::array<index_t, count> positions = [] {
+    ::std::array<index_t, count> result{};
+    index_t child = count;
+    for (index_t i = size - 1; i >= 0; i -= descendants[i] + 1)
+      result[--child] = i;
+    return result;
+  }();
+
+  template <index_t... Indices>
+  static auto select(::std::integer_sequence<index_t, Indices...>)
+      -> typelist<select_t<positions[Indices], Nodes...>...>;
+
+  using type = decltype(select(::std::make_integer_sequence<index_t, count>{}));
+};
+
+// the characters a node of a single character stands for
+template <typename Node>
+struct regex_set_of;
+
+template <char C>
+struct regex_set_of<regex_char<string<C>>>
+{
+  using type = chars_of<string<C>>;
+};
+
+template <char C>
+struct regex_set_of<regex_char<string<'\\', C>>>
+{
+  using type = typename regex_escape<C>::type;
+};
+
+template <char First, char Last>
+struct regex_set_of<regex_range<string<First, '-', Last>>>
+{
+  using type = chars_between<First, Last>;
+};
+
+template <typename Items>
+struct regex_union_of;
+
+template <typename Item>
+struct regex_union_of<typelist<Item>>
+{
+  using type = typename regex_set_of<Item>::type;
+};
+
+template <typename Item, typename... Items>
+struct regex_union_of<typelist<Item, Items...>>
+{
+  using type = chars_union<typename regex_set_of<Item>::type, typename regex_union_of<typelist<Items...>>::type>;
+};
+
+template <typename... Items>
+struct regex_set_of<regex_class<Items...>>
+{
+  using type = typename regex_union_of<typename regex_children<Items...>::type>::type;
+};
+
+template <typename... Items>
+struct regex_set_of<regex_negated_class<Items...>>
+{
+  using type = chars_complement<typename regex_set_of<regex_class<Items...>>::type>;
+};
+
+// the dot matches any character but a line break
+template <typename... Match>
+struct regex_set_of<regex_any<Match...>>
+{
+  using type = chars_complement<chars_of<string<'\n'>>>;
+};
+
+// { Count } optional occurences, each one only tried after the one before it matched
+template <typename Parser, index_t Count>
+struct regex_at_most
+{
+  using type = optional<sequence<Parser, typename regex_at_most<Parser, Count - 1>::type>>;
+};
+
+template <typename Parser>
+struct regex_at_most<Parser, 1>
+{
+  using type = optional<Parser>;
+};
+
+// the bounds of a quantifier, { max } is -1 when there is none
+struct regex_bounds
+{
+  index_t min = 1;
+  index_t max = 1;
+  bool valid = true;
+};
+
+constexpr regex_bounds
+read_bounds(::std::string_view text)
+{
+  if (text == "*")
+    return regex_bounds{0, -1};
+  if (text == "+")
+    return regex_bounds{1, -1};
+  if (text == "?")
+    return regex_bounds{0, 1};
+  regex_bounds result{0, 0};
+  ::std::size_t i = 1;
+  for (; text[i] >= '0' && text[i] <= '9'; ++i)
+    result.min = result.min * 10 + (text[i] - '0');
+  if (text[i] == '}')
+    result.max = result.min;
+  else if (text[i + 1] == '}')
+    result.max = -1;
+  else
+  {
+    for (++i; text[i] >= '0' && text[i] <= '9'; ++i)
+      result.max = result.max * 10 + (text[i] - '0');
+    result.valid = result.min <= result.max;
+  }
+  return result;
+}
+
+template <typename Parser, index_t Min, index_t Max>
+constexpr auto
+quantify()
+{
+  if constexpr (Max < 0 && Min == 0)
+    return zero_or_more<Parser>{};
+  else if constexpr (Max < 0 && Min == 1)
+    return one_or_more<Parser>{};
+  else if constexpr (Max < 0)
+    return repeat_minimum<Parser, Min>{};
+  else if constexpr (Max == Min)
+    return repeat<Parser, Min>{};
+  else if constexpr (Min == 0)
+    return typename regex_at_most<Parser, Max>::type{};
+  else
+    return sequence<repeat<Parser, Min>, typename regex_at_most<Parser, Max - Min>::type>{};
+}
+
+// the parser a node stands for as { type }, and whether its quantifiers are well formed as { valid }, nodes
+// without a specialization are single characters
+template <typename Node>
+struct regex_syntax
+{
+  using type = char_class<typename regex_set_of<Node>::type>;
+  static constexpr bool valid = true;
+};
+
+template <typename Children>
+struct regex_piece_syntax;
+
+template <typename Atom>
+struct regex_piece_syntax<typelist<Atom>> : regex_syntax<Atom>
+{
+};
+
+template <typename Atom, char... Chars>
+struct regex_piece_syntax<typelist<Atom, regex_quantifier<string<Chars...>>>>
+{
+  static constexpr regex_bounds bounds = read_bounds(string<Chars...>{}.view());
+  using type =
+      decltype(quantify<typename regex_syntax<Atom>::type, bounds.min, bounds.valid ? bounds.max : bounds.min>());
+  static constexpr bool valid = regex_syntax<Atom>::valid && bounds.valid;
+};
+
+template <template <typename...> typename Combinator, typename Children>
+struct regex_list_syntax;
+
+template <template <typename...> typename Combinator, typename Child>
+struct regex_list_syntax<Combinator, typelist<Child>> : regex_syntax<Child>
+{
+};
+
+template <template <typename...> typename Combinator, typename... Children>
+struct regex_list_syntax<Combinator, typelist<Children...>>
+{
+  using type = Combinator<typename regex_syntax<Children>::type...>;
+  static constexpr bool valid = (regex_syntax<Children>::valid && ...);
+};
+
+template <typename... Children>
+struct regex_syntax<regex_piece<Children...>> : regex_piece_syntax<typename regex_children<Children...>::type>
+{
+};
+
+template <typename... Pieces>
+struct regex_syntax<regex_concat<Pieces...>> : regex_list_syntax<sequence, typename regex_children<Pieces...>::type>
+{
+};
+
+template <typename... Branches>
+struct regex_syntax<regex_alternation<Branches...>>
+    : regex_list_syntax<one_of, typename regex_children<Branches...>::type>
+{
+};
+
+// the node of the whole pattern, the only direct child of the parse tree
+template <typename Tree>
+struct regex_root;
+
+template <typename... Nodes>
+struct regex_root<typelist<Nodes...>>
+{
+  using type = typename regex_children<Nodes...>::type::head_type;
+};
+
+// the syntax of the patterns regex(...) accepts, a subset of ecmascript without anchors, backreferences,
+// lookarounds or lazy quantifiers
+struct regex_expression_rule
+{
+  static constexpr auto definition();
+};
+
+constexpr auto regex_escaped = one_char(STR("\\")) & anything{};
+constexpr auto regex_literal = ((!one_char(STR("\\.|?*+()[]{}^$"))) | regex_escaped).generate(regex_char<>{});
+constexpr auto regex_class_char = !one_char(STR("\\]-"));
+constexpr auto regex_class_item =
+    (regex_class_char & one_char(STR("-")) & regex_class_char).generate(regex_range<>{}) |
+    ((!one_char(STR("\\]"))) | regex_escaped).generate(regex_char<>{});
+constexpr auto regex_set =
+    one_char(STR("[")) &
+    ((one_char(STR("^")) & +regex_class_item).generate(regex_negated_class<>{}) |
+     (+regex_class_item).generate(regex_class<>{})) &
+    one_char(STR("]"));
+constexpr auto regex_group =
+    one_char(STR("(")) & ~one_string(STR("?:")) & rule<regex_expression_rule>{} & one_char(STR(")"));
+constexpr auto regex_atom_syntax = one_char(STR(".")).generate(regex_any<>{}) | regex_set | regex_group | regex_literal;
+constexpr auto regex_digit = range(CHR('0'), CHR('9'));
+constexpr auto regex_quantifier_syntax =
+    (one_char(STR("*+?")) |
+     (one_char(STR("{")) & +regex_digit & ~(one_char(STR(",")) & *regex_digit) & one_char(STR("}"))))
+        .generate(regex_quantifier<>{});
+constexpr auto regex_branch = (+(regex_atom_syntax & ~regex_quantifier_syntax).generate(regex_piece<>{}))
+                                  .generate(regex_concat<>{});
+constexpr auto regex_expression =
+    (regex_branch & *(one_char(STR("|")) & regex_branch)).generate(regex_alternation<>{});
+
+constexpr auto
+regex_expression_rule::definition()
+{
+  return regex_expression;
+}
+
+template <typename Parser>
+constexpr const auto &regex_table = dfa_of<Parser>;
+
+// the characters no match can start with, a search skips runs of them with scan(...), none when the expression
+// matches empty and so matches everywhere
+template <typename Parser>
+struct regex_skipped
+{
+  static constexpr char_table table()
+  {
+    char_table result;
+    if (regex_table<Parser>.accepting[regex_table<Parser>.start])
+      return result;
+    for (int c = 0; c < 256; ++c)
+      if (regex_table<Parser>.next[regex_table<Parser>.start][c] == 0)
+        result.insert(static_cast<char>(c));
+    return result;
+  }
+};
+} // namespace detail
+
+// a regular expression compiled into a dfa table, unlike the combinators it describes it matches the longest
+// prefix of the input in the expression's language, whatever the order of its alternatives
+template <typename Parser>
+struct regex_matcher
+{
+  using parser_tag = tag_t;
+  constexpr regex_matcher() {}
+
+  template <typename InputString, typename = if_compile_time_string<InputString>>
+  constexpr auto parse(InputString) const
+  {
+    constexpr auto input_string = as_slice(InputString{});
+    constexpr auto input = input_string.view();
+    constexpr index_t end = regex_table<Parser>.match(input.data(), 0, static_cast<index_t>(input.size()));
+    if constexpr (end == no_match)
+      return parsed<decltype(take<0>(input_string)), decltype(input_string), status::failure>{};
+    else
+      return parsed<decltype(take<end>(input_string)), decltype(drop<end>(input_string)), status::success>{};
+  }
+
+  constexpr auto parse(::std::string_view input) const { return runtime_parse(regex_matcher<Parser>{}, input); }
+
+  template <typename State>
+  constexpr index_t parse_at(State &state, index_t position) const
+  {
+    index_t examined = position;
+    const index_t end = regex_table<Parser>.match(state.data, position, state.size(), examined);
+    state.examine(examined);
+    return end;
+  }
+
+  // whether the whole of { input } is in the expression's language
+  constexpr bool match(::std::string_view input) const
+  {
+    const index_t size = static_cast<index_t>(input.size());
+    return regex_table<Parser>.match(input.data(), 0, size) == size;
+  }
+
+  // the leftmost longest match in { input }, positions no match can start at are skipped a run at a time
+  constexpr parsed_view search(::std::string_view input) const
+  {
+    const index_t size = static_cast<index_t>(input.size());
+    for (index_t position = 0;; ++position)
+    {
+      position =
+          scan(table_of<regex_skipped<Parser>>, nibbles_of<regex_skipped<Parser>>, input.data(), position, size);
+      const index_t end = regex_table<Parser>.match(input.data(), position, size);
+      if (end != no_match)
+        return parsed_view{input, position, end - position, status::success};
+      if (position >= size)
+        return parsed_view{input, 0, 0, status::failure};
+    }
+  }
+
+  template <template <typename...> typename Output>
+  constexpr auto generate(Output<>) const
+  {
+    return generator(decltype(*this){}, Output<>{});
+  }
+
+  constexpr auto operator!() const { return filter<regex_matcher<Parser>>{}; }
+  constexpr auto operator~() const { return optional<regex_matcher<Parser>>{}; }
+  constexpr auto operator+() const { return one_or_more<regex_matcher<Parser>>{}; }
+  constexpr auto operator*() const { return zero_or_more<regex_matcher<Parser>>{}; }
+
+  template <index_t I>
+  constexpr auto operator[](::std::integral_constant<index_t, I>) const
+  {
+    return repeat<regex_matcher<Parser>, I>{};
+  }
+};
+} // namespace cxl::parse
+
+namespace cxl
+{
+inline namespace detail
+{
+// whether { pattern } has an escape other regex engines read as an anchor or a backreference, \b \B \A \z \Z \G or
+// \1 to \9, these would otherwise stand for their character like any escape without a meaning of its own
+constexpr bool
+regex_has_anchor_escape(::std::string_view pattern)
+{
+  constexpr ::std::string_view anchors = "bBAzZG123456789";
+  for (::std::size_t i = 0; i + 1 < pattern.size(); ++i)
+    if (pattern[i] == '\\')
+    {
+      if (anchors.find(pattern[i + 1]) != ::std::string_view::npos)
+        return true;
+      ++i;
+    }
+  return false;
+}
+} // namespace detail
+
+// compiles { Pattern }, a compile-time string such as STR("[0-9]+(\\.[0-9]*)?"), into a regex_matcher<...>,
+// a pattern outside the supported syntax or too large for the table is a compile error
+template <typename Pattern>
+constexpr auto
+regex(Pattern)
+{
+  using namespace parse;
+  constexpr bool anchored = regex_has_anchor_escape(Pattern{}.view());
+  static_assert(!anchored, "regex(...) does not support anchors and backreferences, \\b \\B \\A \\z \\Z \\G and \\1 to \\9");
+  constexpr auto result = regex_expression.parse(Pattern{});
+  constexpr bool well_formed = result.status() && result.remainder().size() == 0;
+  static_assert(well_formed, "regex(...) supports characters, escapes, ., [...], (...), (?:...), |, *, +, ? and {n,m}");
+  if constexpr (well_formed && !anchored)
+  {
+    using syntax = regex_syntax<typename regex_root<decltype(result.tree())>::type>;
+    static_assert(syntax::valid, "regex(...) quantifier {n,m} needs n <= m");
+    using parser = decltype(simplify(typename syntax::type{}));
+    static_assert(!dfa_build_of<parser>.overflowed, "regex(...) pattern is too large for a dfa table");
+    return regex_matcher<parser>{};
+  }
+}
+} // namespace cxl
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "utility.hpp"
+
+#include <cstdint>
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define CXL_HAS_IS_CONSTANT_EVALUATED
+#endif
+#endif
+
+// vectorized scans need the x86 intrinsics, the target attributes and runtime cpu detection of gcc and clang,
+// and a way to stay out of them while a parse is evaluated during compilation
+#if defined(CXL_HAS_IS_CONSTANT_EVALUATED) && (defined(__GNUC__) || defined(__clang__)) &&                  \
+    (defined(__x86_64__) || defined(__i386__)) && !defined(CXL_NO_SIMD)
+#define CXL_HAS_SIMD_SCAN
+#include <immintrin.h>
+#endif
+
+namespace cxl::parse
+{
+
+inline namespace detail
+{
+// a set of characters as a 256-bit bitmap, membership is a single lookup both at compile-time and at runtime
+struct char_table
+{
+  ::std::uint64_t bits[4] = {};
+
+  constexpr bool contains(char c) const
+  {
+    const auto index = static_cast<unsigned char>(c);
+    return (bits[index >> 6] >> (index & 63)) & 1;
+  }
+
+  constexpr void insert(char c)
+  {
+    const auto index = static_cast<unsigned char>(c);
+    bits[index >> 6] |= ::std::uint64_t(1) << (index & 63);
+  }
+
+  constexpr void insert(const char_table &other)
+  {
+    for (int i = 0; i < 4; ++i)
+      bits[i] |= other.bits[i];
+  }
+
+  constexpr bool empty() const { return (bits[0] | bits[1] | bits[2] | bits[3]) == 0; }
+
+  constexpr bool intersects(const char_table &other) const
+  {
+    for (int i = 0; i < 4; ++i)
+      if ((bits[i] & other.bits[i]) != 0)
+        return true;
+    return false;
+  }
+};
+
+// the same set laid out for byte shuffles, a character is in the set when bit { c >> 4 } is set in the row
+// { c & 15 }, rows for the high nibbles 0-7 are in { low } and those for 8-15 in { high }
+struct nibble_table
+{
+  ::std::uint8_t low[16] = {};
+  ::std::uint8_t high[16] = {};
+};
+
+constexpr nibble_table
+to_nibbles(const char_table &table)
+{
+  nibble_table result;
+  for (int c = 0; c < 256; ++c)
+    if (table.contains(static_cast<char>(c)))
+    {
+      if ((c >> 4) < 8)
+        result.low[c & 15] |= ::std::uint8_t(1 << (c >> 4));
+      else
+        result.high[c & 15] |= ::std::uint8_t(1 << ((c >> 4) - 8));
+    }
+  return result;
+}
+
+#if defined(CXL_HAS_SIMD_SCAN)
+// each kernel returns the position of the first character not in the set, or the first position past the last
+// whole stride, the caller finishes the tail one character at a time
+__attribute__((target("ssse3"))) inline index_t
+scan_ssse3(const nibble_table &nibbles, const char *data, index_t position, index_t size)
+{
+  const __m128i low_rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(nibbles.low));
+  const __m128i high_rows = _mm_loadu_si128(reinterpret_cast<const __m128i *>(nibbles.high));
+  const __m128i bit_of = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  const __m128i eight = _mm_set1_epi8(8);
+  for (; position + 16 <= size; position += 16)
+  {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + position));
+    const __m128i lo = _mm_and_si128(chars, nibble);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(chars, 4), nibble);
+    const __m128i upper = _mm_cmpeq_epi8(_mm_and_si128(hi, eight), eight);
+    const __m128i row = _mm_or_si128(_mm_andnot_si128(upper, _mm_shuffle_epi8(low_rows, lo)),
+                                     _mm_and_si128(upper, _mm_shuffle_epi8(high_rows, lo)));
+    const __m128i miss = _mm_cmpeq_epi8(_mm_and_si128(row, _mm_shuffle_epi8(bit_of, hi)), _mm_setzero_si128());
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(miss));
+    if (mask != 0)
+      return position + __builtin_ctz(mask);
+  }
+  return position;
+}
+
+__attribute__((target("avx2"))) inline index_t
+scan_avx2(const nibble_table &nibbles, const char *data, index_t position, index_t size)
+{
+  const __m256i low_rows =
+      _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(nibbles.low)));
+  const __m256i high_rows =
+      _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(nibbles.high)));
+  const __m256i bit_of = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                          1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  const __m256i eight = _mm256_set1_epi8(8);
+  for (; position + 32 <= size; position += 32)
+  {
+    const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + position));
+    const __m256i lo = _mm256_and_si256(chars, nibble);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble);
+    const __m256i upper = _mm256_cmpeq_epi8(_mm256_and_si256(hi, eight), eight);
+    const __m256i row = _mm256_blendv_epi8(
+        _mm256_shuffle_epi8(low_rows, lo), _mm256_shuffle_epi8(high_rows, lo), upper);
+    const __m256i miss =
+        _mm256_cmpeq_epi8(_mm256_and_si256(row, _mm256_shuffle_epi8(bit_of, hi)), _mm256_setzero_si256());
+    const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(miss));
+    if (mask != 0)
+      return position + __builtin_ctz(mask);
+  }
+  return scan_ssse3(nibbles, data, position, size);
+}
+
+enum class simd_level
+{
+  none,
+  ssse3,
+  avx2
+};
+
+// the cpu is only asked once, the first time a runtime scan runs
+inline simd_level
+detected_simd_level()
+{
+  static const simd_level level = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+      return simd_level::avx2;
+    else if (__builtin_cpu_supports("ssse3"))
+      return simd_level::ssse3;
+    else
+      return simd_level::none;
+  }();
+  return level;
+}
+
+inline index_t
+scan_simd(const nibble_table &nibbles, const char *data, index_t position, index_t size)
+{
+  switch (detected_simd_level())
+  {
+  case simd_level::avx2:
+    return scan_avx2(nibbles, data, position, size);
+  case simd_level::ssse3:
+    return scan_ssse3(nibbles, data, position, size);
+  default:
+    return position;
+  }
+}
+#endif
+
+// returns the end of the run of characters of { table } starting at { position }, vectorized at runtime
+// when the cpu allows it, one character at a time during compilation
+constexpr index_t
+scan(const char_table &table, const nibble_table &nibbles, const char *data, index_t position, index_t size)
+{
+#if defined(CXL_HAS_SIMD_SCAN)
+  if (!__builtin_is_constant_evaluated())
+    position = scan_simd(nibbles, data, position, size);
+#else
+  (void)nibbles;
+#endif
+  while (position < size && table.contains(data[position]))
+    ++position;
+  return position;
+}
+} // namespace detail
+} // namespace cxl::parse
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "parsers.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <type_traits>
+
+namespace cxl::parse
+{
+
+inline namespace detail
+{
+// the state of a parse over a partial input, every leaf tells how far it looked, so a result that never looked at
+// the end of what arrived so far is the result the whole stream will give
+struct stream_state : runtime_state
+{
+  using runtime_state::runtime_state;
+
+  index_t furthest = 0;
+
+  constexpr void examine(index_t end) { furthest = ::std::max(furthest, end); }
+  constexpr bool saw_end() const { return furthest > size(); }
+};
+} // namespace detail
+
+// parses a stream made of { RecordParser } matches, separated by { SeparatorParser } ones when it is not void, as
+// it arrives in chunks of any size, every record is handed to a callback as soon as the characters after it show it
+// is complete, only the record being read is kept, so { Capacity } needs to hold the largest record and separator
+template <index_t Capacity, typename RecordParser, typename SeparatorParser = void>
+struct stream_parser
+{
+  constexpr stream_parser() {}
+  constexpr stream_parser(RecordParser) {}
+  // a template, so a stream_parser<...> without separator has no constructor taking a void one
+  template <typename Separator, typename = ::std::enable_if_t<::std::is_same_v<Separator, SeparatorParser>>>
+  constexpr stream_parser(RecordParser, Separator)
+  {
+  }
+
+  // reads { chunk }, calling { on_record } with a string_view of every record it completes, the view refers into
+  // the parser's buffer and is only valid during the call, returns false once the stream failed to parse
+  template <typename OnRecord>
+  constexpr bool feed(::std::string_view chunk, OnRecord &&on_record)
+  {
+    while (m_status && !chunk.empty())
+    {
+      compact();
+      // a full buffer only overflows once more input arrives, a record waiting on what follows it is completed by
+      // finish(...) when the stream ends there
+      if (m_size == Capacity)
+      {
+        m_overflowed = true;
+        m_status = false;
+        break;
+      }
+      const index_t count = ::std::min(Capacity - m_size, static_cast<index_t>(chunk.size()));
+      for (index_t i = 0; i < count; ++i)
+        m_data[m_size + i] = chunk[i];
+      m_size += count;
+      chunk.remove_prefix(count);
+      drain(false, on_record);
+    }
+    return m_status;
+  }
+
+  // the stream ended, the records still waiting on what would follow them are completed, returns whether the whole
+  // stream was a sequence of records
+  template <typename OnRecord>
+  constexpr bool finish(OnRecord &&on_record)
+  {
+    if (m_status)
+      drain(true, on_record);
+    m_status = m_status && m_begin == m_size;
+    return m_status;
+  }
+
+  // the stream starts over, without any record read
+  constexpr void reset()
+  {
+    m_begin = 0;
+    m_size = 0;
+    m_end = 0;
+    m_records = 0;
+    m_status = true;
+    m_overflowed = false;
+  }
+
+  constexpr bool status() const { return m_status; }
+  // whether a record did not fit in { Capacity } characters
+  constexpr bool overflowed() const { return m_overflowed; }
+  // the number of records read so far
+  constexpr index_t size() const { return m_records; }
+  // the offset in the stream of the first character not part of a complete record, where a failure was found
+  constexpr index_t end() const { return m_end; }
+
+private:
+  // the characters of the records read are dropped before new ones are appended
+  constexpr void compact()
+  {
+    for (index_t i = m_begin; i < m_size; ++i)
+      m_data[i - m_begin] = m_data[i];
+    m_size -= m_begin;
+    m_begin = 0;
+  }
+
+  template <typename OnRecord>
+  constexpr void drain(bool last, OnRecord &on_record)
+  {
+    while (m_begin < m_size)
+    {
+      stream_state state{::std::string_view{m_data.data() + m_begin, static_cast<::std::size_t>(m_size - m_begin)}};
+      index_t start = 0;
+      if constexpr (!::std::is_void_v<SeparatorParser>)
+        if (m_records > 0)
+          start = decltype(simplify(SeparatorParser{})){}.parse_at(state, 0);
+      const index_t end =
+          start == no_match ? no_match : decltype(simplify(RecordParser{})){}.parse_at(state, start);
+      if (!last && state.saw_end())
+        return;
+      if (end == no_match || end == 0)
+      {
+        m_status = false;
+        return;
+      }
+      on_record(::std::string_view{m_data.data() + m_begin + start, static_cast<::std::size_t>(end - start)});
+      ++m_records;
+      m_begin += end;
+      m_end += end;
+    }
+  }
+
+  ::std::array<char, Capacity> m_data{};
+  index_t m_begin = 0;
+  index_t m_size = 0;
+  index_t m_end = 0;
+  index_t m_records = 0;
+  bool m_status = true;
+  bool m_overflowed = false;
+};
+
+// a stream_parser<...> of records of { record }, being plain constexpr code it also runs during compilation
+template <index_t Capacity, typename RecordParser>
+constexpr auto
+stream(RecordParser record)
+{
+  return stream_parser<Capacity, RecordParser>{record};
+}
+
+// a stream_parser<...> of records of { record } separated by { separator }
+template <index_t Capacity, typename RecordParser, typename SeparatorParser>
+constexpr auto
+stream(RecordParser record, SeparatorParser separator)
+{
+  return stream_parser<Capacity, RecordParser, SeparatorParser>{record, separator};
+}
+} // namespace cxl::parse
@@ -4,17 +4,22 @@
 #include "iterator.hpp"
 #include "typelist.hpp"
 #include "utility.hpp"
+#include <string_view>
 #include <type_traits>
 
 namespace cxl
 {
 
+template <typename Source, index_t Begin, index_t End>
+struct string_slice;
+
 template <char... Chars>
 struct string
 {
   using value_type = char;
 
   constexpr operator const char *() const { return &m_data[0]; }
+  constexpr ::std::string_view view() const { return {&m_data[0], sizeof...(Chars)}; }
 
   template <index_t Index>
   constexpr auto operator[](::std::integral_constant<index_t, Index>) const
@@ -38,11 +43,54 @@ struct string
     return false;
   }
 
+  template <typename Source, index_t Begin, index_t End>
+  constexpr bool operator==(string_slice<Source, Begin, End>) const
+  {
+    return view() == string_slice<Source, Begin, End>{}.view();
+  }
+
 private:
   static constexpr ::std::integral_constant<index_t, sizeof...(Chars)> m_size = {};
   static constexpr char m_data[sizeof...(Chars) + 1] = {Chars..., '\0'};
 };
 
+// a view of the characters [Begin, End) of the cxl::string<...> { Source }, it only refers to the characters
+// of its source, a cxl::string<...> holding them is instantiated on demand through materialize(...)
+template <typename Source, index_t Begin, index_t End>
+struct string_slice
+{
+  using value_type = char;
+  using source_type = Source;
+
+  constexpr ::std::string_view view() const { return Source{}.view().substr(Begin, End - Begin); }
+
+  template <typename T, T Index>
+  constexpr auto operator[](::std::integral_constant<T, Index>) const
+  {
+    return ::std::integral_constant<char, Source{}.view()[Begin + Index]>{};
+  }
+
+  constexpr auto size() const { return ::std::integral_constant<index_t, End - Begin>{}; }
+  constexpr auto offset() const { return ::std::integral_constant<index_t, Begin>{}; }
+
+  constexpr char front() const { return view().front(); }
+  constexpr char back() const { return view().back(); }
+
+  constexpr auto begin() const { return iterator<string_slice<Source, Begin, End>, 0>{}; }
+  constexpr auto end() const { return iterator<string_slice<Source, Begin, End>, End - Begin>{}; }
+
+  template <typename Other>
+  constexpr bool operator==(Other) const
+  {
+    return view() == Other{}.view();
+  }
+  template <typename Other>
+  constexpr bool operator!=(Other) const
+  {
+    return view() != Other{}.view();
+  }
+};
+
 inline namespace detail
 {
 template <typename String, size_t... Indices>
@@ -111,14 +159,77 @@ constexpr auto substr(String, ::std::integral_constant<index_t, Pos>, ::std::int
   return detail::substr_impl(String{}, make_index_range<Pos, (Pos + Len) - 1>());
 }
 
+// creates a slice of the characters [Begin, End) of a string, slicing a slice refers to the same source string
+template <index_t Begin, index_t End, char... Chars>
+constexpr auto slice(string<Chars...>)
+{
+  static_assert(Begin >= 0 && Begin <= End && End <= sizeof...(Chars), "cxl::slice: index out of bounds");
+  return string_slice<string<Chars...>, Begin, End>{};
+}
+
+template <index_t Begin, index_t End, typename Source, index_t SourceBegin, index_t SourceEnd>
+constexpr auto slice(string_slice<Source, SourceBegin, SourceEnd>)
+{
+  static_assert(Begin >= 0 && Begin <= End && End <= SourceEnd - SourceBegin, "cxl::slice: index out of bounds");
+  return string_slice<Source, SourceBegin + Begin, SourceBegin + End>{};
+}
+
+// returns a cxl::string<...> holding the characters of a string or slice
+template <char... Chars>
+constexpr auto materialize(string<Chars...>)
+{
+  return string<Chars...>{};
+}
+
+template <typename Source, index_t Begin, index_t End>
+constexpr auto materialize(string_slice<Source, Begin, End>)
+{
+  if constexpr (Begin == End)
+    return string<>{};
+  else
+    return detail::substr_impl(Source{}, make_index_range<Begin, End - 1>());
+}
+
+// joining two adjacent slices of the same source is free, anything else has to materialize both sides
+template <typename Source, index_t Begin, index_t Middle, index_t End>
+constexpr auto operator+(string_slice<Source, Begin, Middle>, string_slice<Source, Middle, End>)
+{
+  return string_slice<Source, Begin, End>{};
+}
+
+template <typename L, index_t LBegin, index_t LEnd, typename R, index_t RBegin, index_t REnd>
+constexpr auto operator+(string_slice<L, LBegin, LEnd>, string_slice<R, RBegin, REnd>)
+{
+  if constexpr (LBegin == LEnd)
+    return string_slice<R, RBegin, REnd>{};
+  else if constexpr (RBegin == REnd)
+    return string_slice<L, LBegin, LEnd>{};
+  else
+    return materialize(string_slice<L, LBegin, LEnd>{}) + materialize(string_slice<R, RBegin, REnd>{});
+}
+
+template <typename Source, index_t Begin, index_t End, char... Chars>
+constexpr auto operator+(string_slice<Source, Begin, End>, string<Chars...>)
+{
+  return materialize(string_slice<Source, Begin, End>{}) + string<Chars...>{};
+}
+
+template <char... Chars, typename Source, index_t Begin, index_t End>
+constexpr auto operator+(string<Chars...>, string_slice<Source, Begin, End>)
+{
+  return string<Chars...>{} + materialize(string_slice<Source, Begin, End>{});
+}
+
 inline namespace detail
 {
-template <typename Target, typename String, index_t... Indices>
-constexpr auto
-strmatch_impl(Target, String, index_range<Indices...>)
+// a plain loop, a fold expression over every index nests thousands of terms for long strings
+constexpr index_t
+strmatch_impl(::std::string_view target, ::std::string_view string)
 {
-  constexpr auto match_char = [](index_t index) -> index_t { return Target{}[index] == String{}[index] ? 1 : 0; };
-  return ::std::integral_constant<index_t, (0 + ... + match_char(Indices))>{};
+  index_t index = 0;
+  while (index < (index_t)target.size() && index < (index_t)string.size() && target[index] == string[index])
+    ++index;
+  return index;
 }
 } // namespace detail
 
@@ -126,7 +237,7 @@ strmatch_impl(Target, String, index_range<Indices...>)
 template <typename Target, typename String>
 constexpr auto strmatch(Target, String)
 {
-  return strmatch_impl(Target{}, String{}, make_index_range<0, Target{}.size() - 1>());
+  return ::std::integral_constant<index_t, strmatch_impl(Target{}.view(), String{}.view())>{};
 }
 
 template <typename Target, typename String, typename Begin>
@@ -105,46 +105,21 @@ struct typelist<T0, Ts...>
            (sizeof(head_type) < next_types{}.smallest_size()) ? sizeof(head_type) : next_types{}.smallest_size() > {};
   }
 
-  template <index_t Begin, index_t End, index_t Index = 0, typename... Collector>
+  template <index_t Begin, index_t End>
   constexpr auto subrange(::std::integral_constant<index_t, Begin>, ::std::integral_constant<index_t, End>) const
   {
     static_assert(Begin >= 0, "invalid Begin index for typelist<...>::subrange");
     static_assert(End <= m_end_index, "invalid End index for typelist<...>::subrange");
-    if constexpr (Index >= Begin && Index < End)
-    {
-      return subrange<Begin, End, Index + 1, Collector..., select_t<Index, T0, Ts...>>();
-    }
-    else if constexpr (Index < Begin)
-    {
-      return subrange<Begin, End, Index + 1>();
-    }
-    else if constexpr (Index == End)
-    {
-      return typelist<Collector...>{};
-    }
-  }
-
-  template <typename BeginIter, typename EndIter, typename Iter, typename... Collector>
+    if constexpr (Begin >= End)
+      return typelist<>{};
+    else
+      return subrange_impl(make_index_range<Begin, End - 1>());
+  }
+
+  template <typename BeginIter, typename EndIter>
   constexpr auto subrange(BeginIter, EndIter) const
   {
-    constexpr auto begin_index = BeginIter{}.index();
-    constexpr auto end_index = EndIter{}.index();
-    static_assert(begin_index >= 0, "invalid Begin index for typelist<...>::subrange");
-    static_assert(end_index <= m_end_index, "invalid End index for typelist<...>::subrange");
-    constexpr auto true_begin = (typename BeginIter::container_type){}.begin().index();
-    constexpr auto index = Iter{}.index();
-    if constexpr (index >= begin_index && index < end_index)
-    {
-      return subrange<BeginIter, EndIter, decltype(++Iter{}), Collector..., select_t<index, T0, Ts...>>();
-    }
-    else if constexpr (index < begin_index)
-    {
-      return subrange<BeginIter, EndIter, decltype(++Iter{})>();
-    }
-    else if constexpr (index == end_index)
-    {
-      return typelist<Collector...>{};
-    }
+    return subrange(BeginIter{}.index(), EndIter{}.index());
   }
 
   template <index_t Index, template <typename...> typename TL, typename... Deduced>
@@ -222,6 +197,12 @@ struct typelist<T0, Ts...>
   constexpr auto end() const { return iterator<typelist<T0, Ts...>, m_end_index>{}; }
 
 private:
+  template <index_t... Indices>
+  constexpr auto subrange_impl(index_range<Indices...>) const
+  {
+    return typelist<select_t<Indices, T0, Ts...>...>{};
+  }
+
   static constexpr index_t m_end_index = sizeof...(Ts) + 1;
 };
 
@@ -17,20 +17,40 @@ using tag_t = int;
 
 inline namespace detail
 {
-template <index_t, typename...>
-struct select_impl;
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define CXL_HAS_TYPE_PACK_ELEMENT
+#endif
+#endif
 
-template <typename T, typename... Ts>
-struct select_impl<0, T, Ts...>
+template <index_t Index, typename T>
+struct indexed_type
 {
   using type = T;
 };
 
-template <index_t Index, typename T, typename... Ts>
-struct select_impl<Index, T, Ts...>
+template <typename Indices, typename... Ts>
+struct indexed_types;
+
+template <index_t... Indices, typename... Ts>
+struct indexed_types<::std::integer_sequence<index_t, Indices...>, Ts...> : indexed_type<Indices, Ts>...
 {
-  static_assert(Index <= sizeof...(Ts), "parameter pack index out of bounds");
-  using type = typename select_impl<Index - 1, Ts...>::type;
+};
+
+// only the base class holding { Index } can be deduced, so the lookup does not recurse through the pack
+template <index_t Index, typename T>
+indexed_type<Index, T> select_base(const indexed_type<Index, T> &);
+
+template <index_t Index, typename... Ts>
+struct select_impl
+{
+  static_assert(Index >= 0 && Index < (index_t)sizeof...(Ts), "parameter pack index out of bounds");
+#if defined(CXL_HAS_TYPE_PACK_ELEMENT)
+  using type = __type_pack_element<(::std::size_t)Index, Ts...>;
+#else
+  using type = typename decltype(select_base<Index>(
+      ::std::declval<indexed_types<::std::make_integer_sequence<index_t, sizeof...(Ts)>, Ts...>>()))::type;
+#endif
 };
 } // namespace detail
 
@@ -51,25 +71,26 @@ private:
   static constexpr index_t m_range[] = {Indices...};
 };
 
-template <index_t First, index_t Last, index_t... Result>
+inline namespace detail
+{
+// ::std::make_integer_sequence is generated by a compiler intrinsic (or in logarithmic depth) by every
+// standard library, so a range only costs one instantiation no matter how many indices it holds
+template <index_t First, index_t Step, index_t... Offsets>
+constexpr auto
+make_index_range_impl(::std::integer_sequence<index_t, Offsets...>)
+{
+  return index_range<(First + Step * Offsets)...>{};
+}
+} // namespace detail
+
+template <index_t First, index_t Last>
 constexpr auto
 make_index_range()
 {
-  if constexpr (First == Last)
-    return index_range<First>{};
-  if constexpr (sizeof...(Result) == 0)
-    return make_index_range<First, Last, First>();
+  if constexpr (First <= Last)
+    return make_index_range_impl<First, 1>(::std::make_integer_sequence<index_t, Last - First + 1>{});
   else
-  {
-    constexpr index_t result_array[] = {Result...};
-    constexpr index_t previous = result_array[sizeof...(Result) - 1];
-    if constexpr (previous == Last)
-      return index_range<Result...>{};
-    else if constexpr (First < Last)
-      return make_index_range<First, Last, Result..., previous + 1>();
-    else if constexpr (First > Last)
-      return make_index_range<First, Last, Result..., previous - 1>();
-  }
+    return make_index_range_impl<First, -1>(::std::make_integer_sequence<index_t, First - Last + 1>{});
 }
 
 inline namespace detail
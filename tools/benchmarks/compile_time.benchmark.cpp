@@ -0,0 +1,254 @@
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// one synthesized translation unit, { size } is the input length, typelist length or field count
+struct benchmark_case
+{
+  std::string series;
+  int size;
+  std::string source;
+};
+
+struct benchmark_result
+{
+  std::string name;
+  std::string series;
+  int size;
+  std::string status;
+  double wall_seconds;
+  long peak_rss_kb;
+};
+
+std::string csv_row_for_N(int N)
+{
+  // cycles through every kind of value in examples/csv/grammar.h, then pads with whitespace to { N } characters
+  const std::string values[] = {"42", "-7", "3.25", "'quoted'", "+1001", "0.5"};
+  std::string row = values[0];
+  for (int i = 1; row.size() + 2 + values[i % 6].size() <= static_cast<std::size_t>(N); ++i)
+  {
+    row += ", " + values[i % 6];
+  }
+  return row + std::string(N - row.size(), ' ');
+}
+
+std::string csv_source_for_N(int N)
+{
+  std::ostringstream source;
+  source << "#include \"csv/grammar.h\"\n"
+         << "constexpr auto result = grammar::value_list.parse(STR(\"" << csv_row_for_N(N) << "\"));\n"
+         << "static_assert(result.status() && result.remainder().size() == 0);\n"
+         << "int main() { return 0; }\n";
+  return source.str();
+}
+
+std::string typelist_source_for_N(int N)
+{
+  std::ostringstream source;
+  source << "#include <cxl/typelist.hpp>\n#include <type_traits>\n"
+         << "template <int I> struct element { static constexpr int value = I; };\n"
+         << "using list = cxl::typelist<";
+  for (int i = 0; i < N; ++i)
+  {
+    source << (i == 0 ? "" : ", ") << "element<" << i << ">";
+  }
+  source << ">;\n"
+         << "template <cxl::index_t... I>\n"
+         << "constexpr bool walk(cxl::index_range<I...>)\n"
+         << "{\n"
+         << "  return ((decltype(list{}[std::integral_constant<cxl::index_t, I>{}]())::value == I) && ...);\n"
+         << "}\n"
+         << "static_assert(walk(cxl::make_index_range<0, " << N - 1 << ">()));\n"
+         << "static_assert(decltype(list{}.back()())::value == " << N - 1 << ");\n"
+         << "static_assert(decltype(list{}.subrange(std::integral_constant<cxl::index_t, " << N / 2
+         << ">{}, std::integral_constant<cxl::index_t, " << N << ">{}))().size() == " << N - N / 2 << ");\n"
+         << "int main() { return 0; }\n";
+  return source.str();
+}
+
+std::string aggregate_source_for_N(int N)
+{
+  std::ostringstream source;
+  source << "#include <cxl/aggregate.hpp>\n#include <tuple>\n"
+         << "struct fields\n{\n";
+  for (int i = 0; i < N; ++i)
+  {
+    source << "  double v" << i << ";\n";
+  }
+  source << "};\n"
+         << "int main()\n{\n"
+         << "  auto tuple = cxl::destructure(fields{});\n"
+         << "  auto made = cxl::make_struct(";
+  for (int i = 0; i < N; ++i)
+  {
+    source << (i == 0 ? "" : ", ") << i;
+  }
+  source << ");\n"
+         << "  static_assert(std::tuple_size_v<decltype(tuple)> == " << N << ");\n"
+         << "  return static_cast<int>(std::get<0>(tuple)) + made.v1;\n"
+         << "}\n";
+  return source.str();
+}
+
+std::vector<benchmark_case> make_cases()
+{
+  std::vector<benchmark_case> cases;
+  for (int n = 16; n <= 4096; n *= 2)
+  {
+    cases.push_back({"csv_row", n, csv_source_for_N(n)});
+  }
+  for (int n = 16; n <= 2048; n *= 2)
+  {
+    cases.push_back({"typelist", n, typelist_source_for_N(n)});
+  }
+  // aggregate.generator only emits code for up to 32 members
+  for (int n = 1; n <= 32; n *= 2)
+  {
+    cases.push_back({"aggregate", n, aggregate_source_for_N(n)});
+  }
+  return cases;
+}
+
+// compiles one source file, returns the process status and fills in wall time and peak memory of the compiler
+std::string compile(const std::vector<std::string> &command, int timeout_seconds, benchmark_result &result)
+{
+  const auto start = std::chrono::steady_clock::now();
+  auto elapsed = [&start]() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+#if defined(_WIN32)
+  std::string line;
+  for (const auto &argument : command)
+  {
+    line += "\"" + argument + "\" ";
+  }
+  const int exit_code = std::system(line.c_str());
+  result.wall_seconds = elapsed();
+  result.peak_rss_kb = -1;
+  return exit_code == 0 ? "ok" : "failed";
+#else
+  const pid_t child = fork();
+  if (child == 0)
+  {
+    // the driver gets its own process group, so a timeout also stops the compiler processes it spawned
+    setpgid(0, 0);
+    std::vector<char *> arguments;
+    for (const auto &argument : command)
+    {
+      arguments.push_back(const_cast<char *>(argument.c_str()));
+    }
+    arguments.push_back(nullptr);
+    execvp(arguments[0], arguments.data());
+    _exit(127);
+  }
+
+  int status = 0;
+  rusage usage{};
+  bool timed_out = false;
+  // wait4 reports the peak of the driver and every compiler process it waited for (cc1plus, clang -cc1, ...)
+  while (wait4(child, &status, WNOHANG, &usage) == 0)
+  {
+    if (elapsed() > timeout_seconds)
+    {
+      kill(-child, SIGKILL);
+      wait4(child, &status, 0, &usage);
+      timed_out = true;
+      break;
+    }
+    usleep(10000);
+  }
+  result.wall_seconds = elapsed();
+  result.peak_rss_kb = usage.ru_maxrss;
+  if (timed_out)
+    return "timeout";
+  return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? "ok" : "failed";
+#endif
+}
+
+void write_reports(const std::filesystem::path &output_path, const std::vector<benchmark_result> &results)
+{
+  std::ofstream csv(output_path / "compile_time.csv", std::ios::trunc);
+  csv << "case,series,size,status,wall_seconds,peak_rss_kb\n";
+  for (const auto &result : results)
+  {
+    csv << result.name << "," << result.series << "," << result.size << "," << result.status << ","
+        << result.wall_seconds << "," << result.peak_rss_kb << "\n";
+  }
+
+  std::ofstream json(output_path / "compile_time.json", std::ios::trunc);
+  json << "[\n";
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    const auto &result = results[i];
+    json << "  {\"case\": \"" << result.name << "\", \"series\": \"" << result.series << "\", \"size\": " << result.size
+         << ", \"status\": \"" << result.status << "\", \"wall_seconds\": " << result.wall_seconds
+         << ", \"peak_rss_kb\": " << result.peak_rss_kb << "}" << (i + 1 == results.size() ? "\n" : ",\n");
+  }
+  json << "]\n";
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 5)
+  {
+    std::cerr << "[error]: wrong number of arguments\n"
+                 "[note]: usage: {"
+              << argv[0]
+              << "} <compiler> <include-path> <examples-path> <output-path> [--timeout=seconds] [compiler-flags...]\n";
+    return 1;
+  }
+
+  const std::string compiler(argv[1]);
+  const std::filesystem::path include_path(argv[2]), examples_path(argv[3]), output_path(argv[4]);
+  int timeout_seconds = 300;
+  std::vector<std::string> flags;
+  for (int i = 5; i < argc; ++i)
+  {
+    const std::string argument(argv[i]);
+    if (argument.rfind("--timeout=", 0) == 0)
+      timeout_seconds = std::stoi(argument.substr(10));
+    else
+      flags.push_back(argument);
+  }
+
+  std::filesystem::create_directories(output_path);
+  std::vector<benchmark_result> results;
+  std::string failed_series;
+  for (const auto &benchmark : make_cases())
+  {
+    const std::string name = benchmark.series + "_" + std::to_string(benchmark.size);
+    benchmark_result result{name, benchmark.series, benchmark.size, "skipped", 0.0, 0};
+    // sizes only grow within a series, once one size fails the larger ones are not worth waiting for
+    if (benchmark.series != failed_series)
+    {
+      const auto source_path = output_path / (name + ".cpp");
+      std::ofstream(source_path, std::ios::trunc) << benchmark.source;
+
+      std::vector<std::string> command = {compiler, "-std=c++17", "-I" + include_path.string(),
+                                          "-I" + examples_path.string()};
+      command.insert(command.end(), flags.begin(), flags.end());
+      command.insert(command.end(), {"-c", source_path.string(), "-o", (output_path / (name + ".o")).string()});
+      result.status = compile(command, timeout_seconds, result);
+      if (result.status != "ok")
+        failed_series = benchmark.series;
+    }
+    std::cout << name << ": " << result.status << ", " << result.wall_seconds << "s, " << result.peak_rss_kb
+              << "kB\n";
+    results.push_back(result);
+  }
+
+  write_reports(output_path, results);
+  return 0;
+}